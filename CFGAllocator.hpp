@@ -0,0 +1,123 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_ALLOCATOR_HPP_
+#define _CFG_ALLOCATOR_HPP_
+
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+
+
+/**
+	@brief Bytes held through CFGTrackingAllocator, split like hash tables use them.
+*/
+struct CFGAllocationCounter
+{
+	CFGAllocationCounter() : buckets(0U), nodes(0U) {}
+
+	std::size_t buckets;	// arrays of pointers
+	std::size_t nodes;		// everything else
+};
+
+
+/**
+	@brief Allocator which adds the bytes it holds to a counter, used with CFG_TRACK_MEMORY.
+
+	The counter isn't owned and isn't atomic, it belongs to the containers of one owner.
+	Containers keep their own allocator on copy, move and swap, so a counter only
+	sees allocations of its containers. nullptr counter allocates without counting.
+	Hash tables allocate their bucket arrays as arrays of node pointers and their
+	nodes one by one, that's how the counter tells them apart.
+*/
+template<typename T> class CFGTrackingAllocator
+{
+public:
+
+	typedef T value_type;
+	typedef std::false_type propagate_on_container_copy_assignment;
+	typedef std::false_type propagate_on_container_move_assignment;
+	typedef std::false_type propagate_on_container_swap;
+	typedef std::false_type is_always_equal;
+
+	/**
+		@brief Constructor.
+		@param Counter of allocated bytes.
+	*/
+	explicit CFGTrackingAllocator(CFGAllocationCounter* counter = nullptr) :
+		_counter(counter)
+	{
+	}
+
+	template<typename U> CFGTrackingAllocator(const CFGTrackingAllocator<U>& other) :
+		_counter(other.getCounter())
+	{
+	}
+
+	T* allocate(const std::size_t count)
+	{
+		if (_counter) (std::is_pointer<T>::value ? _counter->buckets : _counter->nodes) += count * sizeof(T);
+
+		return std::allocator<T>().allocate(count);
+	}
+
+	void deallocate(T* pointer, const std::size_t count)
+	{
+		if (_counter) (std::is_pointer<T>::value ? _counter->buckets : _counter->nodes) -= count * sizeof(T);
+
+		std::allocator<T>().deallocate(pointer, count);
+	}
+
+	/**
+		@brief Copies of a container take a new allocator without a counter, the owner sets it.
+	*/
+	CFGTrackingAllocator select_on_container_copy_construction() const
+	{
+		return CFGTrackingAllocator();
+	}
+
+	/**
+		@brief Return counter of allocated bytes.
+	*/
+	inline CFGAllocationCounter* getCounter() const
+	{
+		return _counter;
+	}
+
+private:
+	CFGAllocationCounter* _counter;
+
+};
+
+
+template<typename T, typename U> inline bool operator==(const CFGTrackingAllocator<T>& a, const CFGTrackingAllocator<U>& b)
+{
+	return a.getCounter() == b.getCounter();
+}
+
+
+template<typename T, typename U> inline bool operator!=(const CFGTrackingAllocator<T>& a, const CFGTrackingAllocator<U>& b)
+{
+	return a.getCounter() != b.getCounter();
+}
+
+#endif
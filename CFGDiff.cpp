@@ -0,0 +1,243 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGDiff.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+
+CFGDiff::CFGDiff() :
+	_next_id(1U)
+{
+}
+
+
+CFGDiff::~CFGDiff()
+{
+	_subscribers.clear();
+	_key_subscribers.clear();
+	_folded_key_subscribers.clear();
+}
+
+
+const std::vector<CFGDiff::change_data> CFGDiff::compare(const CFGParser& before, const CFGParser& after)
+{
+	std::vector<change_data> changes;
+
+	// Sections of the new config in its order, then sections, which exist only in the old one.
+	std::vector<const std::string*> sections;
+	std::unordered_set<std::string> seen;
+
+	for (const CFGParser* parser : { &after, &before })
+	{
+		for (const CFGParser::section_map::value_type* sec : parser->_order)
+		{
+			if (seen.insert(sec->first).second) sections.push_back(&sec->first);
+		}
+
+		for (const CFGParser::section_map::value_type& sec : parser->_overlay)
+		{
+			if (seen.insert(sec.first).second) sections.push_back(&sec.first);
+		}
+	}
+
+	for (const std::string* section : sections)
+	{
+		const CFGParser::section_data* old_section = find_section(before._buffer, *section);
+		const CFGParser::section_data* new_section = find_section(after._buffer, *section);
+
+		const bool plain = !find_section(before._overlay, *section) && !find_section(after._overlay, *section) &&
+			!(old_section && old_section->references) && !(new_section && new_section->references);
+
+		if (plain && old_section == new_section) continue;
+		if (plain && old_section && new_section && old_section->content == new_section->content && old_section->values.size() == new_section->values.size()) continue;
+
+		compare_section(before, after, *section, changes);
+	}
+
+	return changes;
+}
+
+
+const std::size_t CFGDiff::subscribe(const std::string& section, const std::string& key, const callback_type& callback)
+{
+	subscriber_data subscriber;
+	subscriber.id = _next_id++;
+	subscriber.section = section;
+	subscriber.key = key;
+	subscriber.folded_section = fold(section);
+	subscriber.folded_key = fold(key);
+	subscriber.prefix = false;
+	subscriber.callback = callback;
+
+	_subscribers.push_back(subscriber);
+	this->index_subscriber(_subscribers.size() - 1U);
+
+	return subscriber.id;
+}
+
+
+const std::size_t CFGDiff::subscribePrefix(const std::string& section_prefix, const callback_type& callback)
+{
+	subscriber_data subscriber;
+	subscriber.id = _next_id++;
+	subscriber.section = section_prefix;
+	subscriber.folded_section = fold(section_prefix);
+	subscriber.prefix = true;
+	subscriber.callback = callback;
+
+	_subscribers.push_back(subscriber);
+
+	return subscriber.id;
+}
+
+
+void CFGDiff::unsubscribe(const std::size_t id)
+{
+	_subscribers.erase(std::remove_if(_subscribers.begin(), _subscribers.end(), [id](const subscriber_data& subscriber)
+	{
+		return subscriber.id == id;
+	}), _subscribers.end());
+
+	_key_subscribers.clear();
+	_folded_key_subscribers.clear();
+	for (std::size_t i = 0U; i < _subscribers.size(); ++i) this->index_subscriber(i);
+}
+
+
+const std::size_t CFGDiff::notify(const CFGParser& before, const CFGParser& after)
+{
+	const std::vector<change_data> changes = compare(before, after);
+	if (changes.empty() || _subscribers.empty()) return changes.size();
+
+	std::vector<std::vector<change_data> > batches(_subscribers.size());
+
+	// Names of changes are stored names, a case-insensitive parser keeps them folded.
+	const bool folded = (after.getOptions() & CFGParser::CASE_INSENSITIVE) != 0U;
+	const std::unordered_map<std::string, std::vector<std::size_t> >& key_subscribers = folded ? _folded_key_subscribers : _key_subscribers;
+
+	for (const change_data& change : changes)
+	{
+		const std::unordered_map<std::string, std::vector<std::size_t> >::const_iterator it = key_subscribers.find(change.section + '\0' + change.key);
+		if (it != key_subscribers.end())
+		{
+			for (const std::size_t i : (*it).second) batches[i].push_back(change);
+		}
+
+		for (std::size_t i = 0U; i < _subscribers.size(); ++i)
+		{
+			const subscriber_data& subscriber = _subscribers[i];
+			const std::string& prefix = folded ? subscriber.folded_section : subscriber.section;
+			if (subscriber.prefix && change.section.compare(0U, prefix.size(), prefix) == 0) batches[i].push_back(change);
+		}
+	}
+
+	// Callbacks may unsubscribe, so they are called on a copy.
+	const std::vector<subscriber_data> subscribers = _subscribers;
+	for (std::size_t i = 0U; i < subscribers.size(); ++i)
+	{
+		if (!batches[i].empty()) subscribers[i].callback(batches[i]);
+	}
+
+	return changes.size();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+void CFGDiff::compare_section(const CFGParser& before, const CFGParser& after, const std::string& section, std::vector<change_data>& changes)
+{
+	// Keys in file order of the new config, then keys, which only the old config or the overrides have.
+	std::vector<const std::string*> keys;
+	std::unordered_set<std::string> seen;
+
+	for (const CFGParser* parser : { &after, &before })
+	{
+		const CFGParser::section_data* values = find_section(parser->_buffer, section);
+		if (values)
+		{
+			for (const CFGParser::value_map::value_type* val : values->order)
+			{
+				if (seen.insert(val->first).second) keys.push_back(&val->first);
+			}
+		}
+
+		const CFGParser::section_data* overrides = find_section(parser->_overlay, section);
+		if (overrides)
+		{
+			for (const CFGParser::value_map::value_type& val : overrides->values)
+			{
+				if (seen.insert(val.first).second) keys.push_back(&val.first);
+			}
+		}
+	}
+
+	for (const std::string* key : keys)
+	{
+		const CFGParser::value_data* old_data = before.find_value(section, *key);
+		const CFGParser::value_data* new_data = after.find_value(section, *key);
+
+		change_data change;
+		change.section = section;
+		change.key = *key;
+
+		if (old_data) change.old_value = before.value_of(*old_data, section);
+		if (new_data) change.new_value = after.value_of(*new_data, section);
+
+		if (!old_data) change.type = ADDED;
+		else if (!new_data) change.type = REMOVED;
+		else if (change.old_value != change.new_value) change.type = CHANGED;
+		else
+		{
+			continue;
+		}
+
+		changes.push_back(change);
+	}
+}
+
+
+void CFGDiff::index_subscriber(const std::size_t index)
+{
+	const subscriber_data& subscriber = _subscribers[index];
+	if (subscriber.prefix) return;
+
+	_key_subscribers[subscriber.section + '\0' + subscriber.key].push_back(index);
+	_folded_key_subscribers[subscriber.folded_section + '\0' + subscriber.folded_key].push_back(index);
+}
+
+
+const std::string CFGDiff::fold(const std::string& name)
+{
+	std::string folded = name;
+	std::transform(folded.begin(), folded.end(), folded.begin(), CFGParser::fold_char);
+
+	return folded;
+}
+
+
+const CFGParser::section_data* CFGDiff::find_section(const CFGParser::section_map& sections, const std::string& section)
+{
+	const CFGParser::section_map::const_iterator it = sections.find(section);
+	return (it != sections.end()) ? (*it).second.get() : nullptr;
+}
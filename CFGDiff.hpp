@@ -0,0 +1,141 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_DIFF_HPP_
+#define _CFG_DIFF_HPP_
+
+#include "CFGParser.hpp"
+#include <functional>
+
+
+/**
+	@brief Differences between two parsed configs and notifications about them.
+
+	compare() walks the sections of both configs. A section which both configs share
+	(see CFGParser::set()) or whose content hashes match is skipped without looking
+	at its keys. Only the remaining sections are compared key by key. Values are
+	compared as the getters return them: overrides applied, references expanded.
+
+	Subscribers are called from notify() once per call, with only the changes they
+	asked for, and not at all if none of them changed. For a CASE_INSENSITIVE parser
+	the subscribed names are matched ignoring case, like its getters do.
+
+	@code
+	CFGDiff diff;
+	diff.subscribe("pool", "size", [&](const std::vector<CFGDiff::change_data>&) { rebuildPool(); });
+	diff.subscribePrefix("render", [&](const std::vector<CFGDiff::change_data>& changes) { applyRender(changes); });
+
+	CFGParser fresh("server.ini");
+	diff.notify(current, fresh);
+	current = fresh;
+	@endcode
+*/
+class CFGDiff
+{
+public:
+
+	enum ChangeType
+	{
+		ADDED = 0x01,
+		REMOVED = 0x02,
+		CHANGED = 0x03
+	};
+
+	/**
+		@brief One changed key. Old value is empty for ADDED, new value is empty for REMOVED.
+	*/
+	struct change_data
+	{
+		ChangeType type;
+		std::string section;
+		std::string key;
+		std::string old_value;
+		std::string new_value;
+	};
+
+	typedef std::function<void(const std::vector<change_data>&)> callback_type;
+
+	/**
+		@brief Constructor.
+	*/
+	CFGDiff();
+
+	/**
+		@brief Destructor.
+	*/
+	virtual ~CFGDiff();
+
+	/**
+		@brief Return all added, removed and changed keys, grouped by section.
+	*/
+	static const std::vector<change_data> compare(const CFGParser& before, const CFGParser& after);
+
+	/**
+		@brief Call back on changes of one key. Return id for unsubscribe().
+	*/
+	const std::size_t subscribe(const std::string& section, const std::string& key, const callback_type& callback);
+
+	/**
+		@brief Call back on changes in all sections starting with the prefix. Return id for unsubscribe().
+	*/
+	const std::size_t subscribePrefix(const std::string& section_prefix, const callback_type& callback);
+
+	/**
+		@brief Remove subscriber.
+	*/
+	void unsubscribe(const std::size_t id);
+
+	/**
+		@brief Compare configs and call subscribers, whose keys changed. Return number of changes.
+	*/
+	const std::size_t notify(const CFGParser& before, const CFGParser& after);
+
+protected:
+
+	struct subscriber_data
+	{
+		std::size_t id;
+		std::string section;	// exact name or prefix
+		std::string key;		// empty for prefix subscribers
+		std::string folded_section;	// for CASE_INSENSITIVE parsers
+		std::string folded_key;
+		bool prefix;
+		callback_type callback;
+	};
+
+	void index_subscriber(const std::size_t index);
+
+	static const std::string fold(const std::string& name);
+
+	static void compare_section(const CFGParser& before, const CFGParser& after, const std::string& section, std::vector<change_data>& changes);
+
+	static const CFGParser::section_data* find_section(const CFGParser::section_map& sections, const std::string& section);
+
+private:
+	std::vector<subscriber_data> _subscribers;
+	std::unordered_map<std::string, std::vector<std::size_t> > _key_subscribers; // section + '\0' + key -> indexes in _subscribers
+	std::unordered_map<std::string, std::vector<std::size_t> > _folded_key_subscribers; // the same with folded names
+	std::size_t _next_id;
+
+};
+
+#endif
@@ -0,0 +1,510 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGDocument.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <windows.h>
+#endif
+
+
+CFGDocument::CFGDocument(const std::string& cfg_file) :
+	_file_name(cfg_file),
+	_newline("\n"),
+	_loaded(false),
+	_new_sections(0U)
+{
+	std::ifstream file(cfg_file, std::ios::in | std::ios::binary);
+	if (file.good())
+	{
+		file.seekg(0, std::ios::end);
+		const std::streamoff size = file.tellg();
+		file.seekg(0, std::ios::beg);
+
+		_text.resize(static_cast<std::size_t>(size));
+		if (size > 0) file.read(&_text[0], size);
+
+		std::error_code error;
+		_modified = std::filesystem::last_write_time(cfg_file, error);
+
+		_loaded = true;
+		this->scan();
+	}
+	else
+	{
+		std::cout << "File \"" << cfg_file << "\" not be opened!" << "\n" << std::endl;
+	}
+}
+
+
+CFGDocument::~CFGDocument()
+{
+	_sections.clear();
+	_patches.clear();
+}
+
+
+const bool CFGDocument::isLoaded() const
+{
+	return _loaded;
+}
+
+
+const std::string CFGDocument::getValue(const std::string& section, const std::string& key, const std::string& default_value) const
+{
+	const auto sit = _sections.find(section);
+	if (sit == _sections.end()) return default_value;
+
+	const auto eit = sit->second.entries.find(key);
+	if (eit == sit->second.entries.end()) return default_value;
+
+	const entry_data& entry = eit->second;
+	if (entry.patch != npos) return _patches[entry.patch].value;
+
+	std::string value;
+
+	// The parser drops blanks and backslashes of unquoted values.
+	if (!entry.quoted)
+	{
+		for (std::size_t i = entry.begin; i < entry.end; ++i)
+		{
+			if (_text[i] != ' ' && _text[i] != '\t' && _text[i] != '\\') value += _text[i];
+		}
+
+		return value;
+	}
+
+	for (std::size_t i = entry.begin + 1U; i < entry.end - 1U; ++i)
+	{
+		if (_text[i] == '\\' && i + 1U < entry.end - 1U)
+		{
+			switch (_text[++i])
+			{
+				case 'n': value += '\n'; break;
+				case 't': value += '\t'; break;
+				default: value += _text[i]; break;
+			}
+		}
+		else
+		{
+			value += _text[i];
+		}
+	}
+
+	return value;
+}
+
+
+const bool CFGDocument::setValue(const std::string& section, const std::string& key, const std::string& value)
+{
+	if (!_loaded)
+	{
+		std::cout << "Document \"" << _file_name << "\" isn't loaded!" << "\n}" << std::endl;
+		return false;
+	}
+
+	if (section.empty() || key.empty())
+	{
+		std::cout << "Section and key names can't be empty!" << "\n}" << std::endl;
+		return false;
+	}
+
+	auto sit = _sections.find(section);
+	if (sit == _sections.end())
+	{
+		section_data data;
+		data.insert_offset = _text.size();
+		data.insert_newline = false;
+		data.group = ++_new_sections;
+
+		patch_data header;
+		header.offset = _text.size();
+		header.length = 0U;
+		header.group = data.group;
+		header.order = _patches.size();
+		if (!_text.empty() && _text.back() != '\n') header.prefix = _newline;
+		header.prefix += _newline + "[" + section + "]" + _newline;
+		header.quoted = false;
+		header.has_value = false;
+		_patches.push_back(header);
+
+		sit = _sections.emplace(section, data).first;
+	}
+
+	section_data& sdata = sit->second;
+	auto eit = sdata.entries.find(key);
+
+	if (eit != sdata.entries.end() && eit->second.patch != npos)
+	{
+		_patches[eit->second.patch].value = value;
+		return true;
+	}
+
+	patch_data patch;
+	patch.group = sdata.group;
+	patch.order = _patches.size();
+	patch.value = value;
+	patch.has_value = true;
+
+	if (eit != sdata.entries.end())
+	{
+		entry_data& entry = eit->second;
+		patch.offset = entry.begin;
+		patch.length = entry.end - entry.begin;
+		patch.quoted = entry.quoted;
+		entry.patch = _patches.size();
+	}
+	else
+	{
+		patch.offset = sdata.insert_offset;
+		patch.length = 0U;
+		patch.quoted = false;
+		if (sdata.insert_newline) patch.prefix = _newline;
+		patch.prefix += key + " = ";
+		patch.suffix = _newline;
+
+		entry_data entry;
+		entry.begin = entry.end = sdata.insert_offset;
+		entry.quoted = false;
+		entry.patch = _patches.size();
+		sdata.entries[key] = entry;
+	}
+
+	_patches.push_back(patch);
+	return true;
+}
+
+
+const bool CFGDocument::save()
+{
+	if (!_loaded) return false;
+	if (_patches.empty()) return true;
+
+	bool same_length = true;
+	for (const patch_data& patch : _patches)
+	{
+		if (patch.length != this->patch_text(patch).size())
+		{
+			same_length = false;
+			break;
+		}
+	}
+
+	if (!same_length || !this->write_in_place())
+	{
+		const std::string temp_name = _file_name + ".tmp";
+		if (!this->write_spliced(temp_name)) return false;
+
+		// The old file stays until the new one takes its name in one step, a crash leaves one of them complete.
+#ifdef _WIN32
+		const bool replaced = (MoveFileExA(temp_name.c_str(), _file_name.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+		const bool replaced = (std::rename(temp_name.c_str(), _file_name.c_str()) == 0);
+#endif
+		if (!replaced)
+		{
+			std::remove(temp_name.c_str());
+			std::cout << "File \"" << _file_name << "\" can't be replaced!" << "\n}" << std::endl;
+			return false;
+		}
+	}
+
+	std::error_code error;
+	_modified = std::filesystem::last_write_time(_file_name, error);
+
+	this->apply_patches();
+	return true;
+}
+
+
+const bool CFGDocument::save(const std::string& cfg_file)
+{
+	if (!_loaded) return false;
+
+	return this->write_spliced(cfg_file);
+}
+
+
+void CFGDocument::discardChanges()
+{
+	this->scan();
+}
+
+
+const std::size_t CFGDocument::getPatchNum() const
+{
+	return _patches.size();
+}
+
+
+const bool CFGDocument::isSectionKeyExist(const std::string& section, const std::string& key) const
+{
+	const auto sit = _sections.find(section);
+	return (sit != _sections.end()) ? ((sit->second.entries.find(key) != sit->second.entries.end()) ? true : false) : false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+void CFGDocument::scan()
+{
+	_sections.clear();
+	_patches.clear();
+	_new_sections = 0U;
+	_newline = (_text.find("\r\n") != std::string::npos) ? "\r\n" : "\n";
+
+	const char* data = _text.data();
+	const std::size_t size = _text.size();
+	section_data* current = nullptr;
+	std::size_t pos = 0U;
+
+	while (pos < size)
+	{
+		const char* nl = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+		const std::size_t line_end = nl ? static_cast<std::size_t>(nl - data) : size;
+		const std::size_t next = nl ? line_end + 1U : size;
+
+		std::size_t content_end = line_end;
+		if (content_end > pos && data[content_end - 1U] == '\r') content_end--;
+
+		std::size_t i = pos;
+		while (i < content_end && (data[i] == ' ' || data[i] == '\t')) i++;
+
+		if (i < content_end && data[i] == '[')
+		{
+			std::string name;
+			for (++i; i < content_end && data[i] != ']'; ++i)
+			{
+				if (data[i] != ' ' && data[i] != '\t') name += data[i];
+			}
+
+			if (!name.empty())
+			{
+				auto result = _sections.emplace(name, section_data());
+				current = &result.first->second;
+				if (result.second) current->group = 0U;
+				current->insert_offset = next;
+				current->insert_newline = (nl == nullptr);
+			}
+		}
+		else if (i < content_end && data[i] != ';' && data[i] != '#' && current)
+		{
+			std::string key;
+			for (; i < content_end && data[i] != '='; ++i)
+			{
+				if (data[i] != ' ' && data[i] != '\t') key += data[i];
+			}
+
+			if (i < content_end && !key.empty())
+			{
+				for (++i; i < content_end && (data[i] == ' ' || data[i] == '\t'); ++i);
+
+				entry_data entry;
+				entry.begin = i;
+				entry.end = i;
+				entry.quoted = false;
+				entry.patch = npos;
+
+				if (i < content_end && data[i] == '\"')
+				{
+					std::size_t j = i + 1U;
+					while (j < content_end && data[j] != '\"') j += (data[j] == '\\') ? 2U : 1U;
+
+					if (j < content_end)
+					{
+						entry.end = j + 1U;
+						entry.quoted = true;
+					}
+				}
+
+				if (!entry.quoted)
+				{
+					std::size_t j = i;
+					while (j < content_end && data[j] != ';') j++;
+					while (j > i && (data[j - 1U] == ' ' || data[j - 1U] == '\t')) j--;
+					entry.end = j;
+				}
+
+				current->entries[key] = entry;
+				current->insert_offset = next;
+				current->insert_newline = (nl == nullptr);
+			}
+		}
+
+		pos = next;
+	}
+}
+
+
+const std::string CFGDocument::format_value(const std::string& value, const bool quoted) const
+{
+	bool need_quotes = quoted || value.empty();
+	for (const char& ch : value)
+	{
+		if (ch == ' ' || ch == '\t' || ch == '\n' || ch == ';' || ch == '#' || ch == '=' || ch == '\"' || ch == '\\' || ch == '[' || ch == ']')
+		{
+			need_quotes = true;
+			break;
+		}
+	}
+
+	if (!need_quotes) return value;
+
+	std::string text = "\"";
+	for (const char& ch : value)
+	{
+		switch (ch)
+		{
+			case '\n': text += "\\n"; break;
+			case '\t': text += "\\t"; break;
+			case '\"': text += "\\\""; break;
+			case '\\': text += "\\\\"; break;
+			default: text += ch; break;
+		}
+	}
+
+	return text + "\"";
+}
+
+
+const std::string CFGDocument::patch_text(const patch_data& patch) const
+{
+	if (!patch.has_value) return patch.prefix;
+
+	return patch.prefix + this->format_value(patch.value, patch.quoted) + patch.suffix;
+}
+
+
+const std::vector<const CFGDocument::patch_data*> CFGDocument::sorted_patches() const
+{
+	std::vector<const patch_data*> patches;
+	patches.reserve(_patches.size());
+
+	for (const patch_data& patch : _patches) patches.push_back(&patch);
+
+	std::sort(patches.begin(), patches.end(), [](const patch_data* a, const patch_data* b)
+	{
+		if (a->offset != b->offset) return a->offset < b->offset;
+		if (a->group != b->group) return a->group < b->group;
+		return a->order < b->order;
+	});
+
+	return patches;
+}
+
+
+const bool CFGDocument::write_spliced(const std::string& cfg_file) const
+{
+	std::vector<char> buffer(1U << 16U);
+	std::ofstream file;
+	file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	file.open(cfg_file, std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!file.good())
+	{
+		std::cout << "File \"" << cfg_file << "\" can't be opened for writing!" << "\n}" << std::endl;
+		return false;
+	}
+
+	std::size_t cursor = 0U;
+	for (const patch_data* patch : this->sorted_patches())
+	{
+		file.write(_text.data() + cursor, static_cast<std::streamsize>(patch->offset - cursor));
+
+		const std::string text = this->patch_text(*patch);
+		file.write(text.data(), static_cast<std::streamsize>(text.size()));
+
+		cursor = patch->offset + patch->length;
+	}
+
+	file.write(_text.data() + cursor, static_cast<std::streamsize>(_text.size() - cursor));
+	file.close();
+
+	return !file.fail();
+}
+
+
+const bool CFGDocument::write_in_place() const
+{
+	// The changed bytes are written by one call and only over the bytes they were read from. If they span more
+	// than a page, or the file changed since it was read, the caller writes a temporary file and renames it.
+	const std::vector<const patch_data*> patches = this->sorted_patches();
+	const std::size_t begin = patches.front()->offset;
+	const std::size_t end = patches.back()->offset + patches.back()->length;
+	if (end - begin > IN_PLACE_MAX) return false;
+
+	std::error_code error;
+	if (std::filesystem::last_write_time(_file_name, error) != _modified || error) return false;
+
+	std::fstream file(_file_name, std::ios::in | std::ios::out | std::ios::binary);
+	if (!file.good()) return false;
+
+	file.seekg(0, std::ios::end);
+	if (static_cast<std::streamoff>(file.tellg()) != static_cast<std::streamoff>(_text.size())) return false;
+
+	std::string current(end - begin, '\0');
+	file.seekg(static_cast<std::streamoff>(begin));
+	file.read(&current[0], static_cast<std::streamsize>(current.size()));
+	if (!file.good() || _text.compare(begin, end - begin, current) != 0) return false;
+
+	std::string text;
+	text.reserve(end - begin);
+
+	std::size_t cursor = begin;
+	for (const patch_data* patch : patches)
+	{
+		text.append(_text, cursor, patch->offset - cursor);
+		text += this->patch_text(*patch);
+		cursor = patch->offset + patch->length;
+	}
+
+	file.seekp(static_cast<std::streamoff>(begin));
+	file.write(text.data(), static_cast<std::streamsize>(text.size()));
+	file.close();
+
+	return !file.fail();
+}
+
+
+void CFGDocument::apply_patches()
+{
+	std::string text;
+	text.reserve(_text.size());
+
+	std::size_t cursor = 0U;
+	for (const patch_data* patch : this->sorted_patches())
+	{
+		text.append(_text, cursor, patch->offset - cursor);
+		text += this->patch_text(*patch);
+		cursor = patch->offset + patch->length;
+	}
+
+	text.append(_text, cursor, std::string::npos);
+	_text.swap(text);
+
+	this->scan();
+}
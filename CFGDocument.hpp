@@ -0,0 +1,182 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_DOCUMENT_HPP_
+#define _CFG_DOCUMENT_HPP_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <filesystem>
+
+
+/**
+	@brief Format-preserving view of a single CFG file, used for editing.
+
+	The document keeps the original file text and remembers the byte range of
+	every value. Setters don't touch the text, they only record patches. On save
+	the untouched bytes are copied as is, so comments, ordering and formatting
+	survive, and only the changed ranges are rewritten.
+
+	Includes are not followed: every file is edited as its own document.
+
+	@code
+	CFGDocument doc("render.ini");
+	doc.setValue("render", "shadow_bias", "0.5");
+	doc.save();
+	@endcode
+*/
+class CFGDocument
+{
+public:
+
+	/**
+		@brief Constructor.
+		@param Config file path.
+	*/
+	CFGDocument(const std::string& cfg_file);
+
+	/**
+		@brief Destructor.
+	*/
+	virtual ~CFGDocument();
+
+	/**
+		@brief Return true, if the file was read.
+	*/
+	const bool isLoaded() const;
+
+	/**
+		@brief Return current value of the key(with pending changes). Otherwise return default value.
+
+		The value reads as CFGParser gives it: escapes of quoted values are decoded,
+		blanks of unquoted values are dropped("1, 2, 3" gives "1,2,3").
+	*/
+	const std::string getValue(const std::string& section, const std::string& key, const std::string& default_value = "") const;
+
+	/**
+		@brief Record a new value for the key. Missing keys and sections are appended.
+	*/
+	const bool setValue(const std::string& section, const std::string& key, const std::string& value);
+
+	/**
+		@brief Write the document back to its own file.
+
+		If every change keeps the length of the replaced range, all of them fit in one
+		page and the file wasn't modified since it was read(size, time and the replaced
+		bytes match), the changed bytes are overwritten in place by one write. Otherwise the file is spliced into a
+		temporary file which then replaces the original.
+	*/
+	const bool save();
+
+	/**
+		@brief Write the document with all changes to another file.
+	*/
+	const bool save(const std::string& cfg_file);
+
+	/**
+		@brief Drop all changes which wasn't saved.
+	*/
+	void discardChanges();
+
+	/**
+		@brief Return number of pending changes.
+	*/
+	const std::size_t getPatchNum() const;
+
+	/**
+		@brief Short check, exist section or not.
+	*/
+	inline const bool isSectionExist(const std::string& section) const
+	{
+		return (_sections.find(section) != _sections.end()) ? true : false;
+	}
+
+	/**
+		@brief Short check, exist key in section or not.
+	*/
+	const bool isSectionKeyExist(const std::string& section, const std::string& key) const;
+
+protected:
+
+	static const std::size_t npos = static_cast<std::size_t>(-1);
+
+	static const std::size_t IN_PLACE_MAX = 4096U;	// bytes from the first to the last change of an in-place save
+
+	struct entry_data
+	{
+		std::size_t begin;	// value range in the original text, quotes included
+		std::size_t end;
+		bool quoted;
+		std::size_t patch;	// index in _patches or npos
+	};
+
+	struct section_data
+	{
+		std::size_t insert_offset;	// where a new key of this section goes
+		bool insert_newline;		// the last line of the section has no line ending
+		std::size_t group;			// 0 for sections of the file, otherwise order of appending
+		std::unordered_map<std::string, entry_data> entries;
+	};
+
+	struct patch_data
+	{
+		std::size_t offset;
+		std::size_t length;
+		std::size_t group;
+		std::size_t order;
+		std::string prefix;
+		std::string value;
+		std::string suffix;
+		bool quoted;
+		bool has_value;
+	};
+
+	void scan();
+
+	const std::string format_value(const std::string& value, const bool quoted) const;
+
+	const std::string patch_text(const patch_data& patch) const;
+
+	const std::vector<const patch_data*> sorted_patches() const;
+
+	const bool write_spliced(const std::string& cfg_file) const;
+
+	const bool write_in_place() const;
+
+	void apply_patches();
+
+private:
+	std::string _file_name;
+	std::string _text;
+	std::filesystem::file_time_type _modified; // of the file, when _text was read or saved
+	std::string _newline;
+	bool _loaded;
+	std::unordered_map<std::string, section_data> _sections;
+	std::vector<patch_data> _patches;
+	std::size_t _new_sections;
+
+};
+
+#endif
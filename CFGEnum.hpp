@@ -0,0 +1,242 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_ENUM_HPP_
+#define _CFG_ENUM_HPP_
+
+#include <string_view>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+
+
+/**
+	@brief Name and value of an enum, one entry of enum_traits.
+*/
+template<typename E> struct enum_entry
+{
+	std::string_view name;
+	E value;
+};
+
+/**
+	@brief Names of an enum for CFGParser::getEnum(). Specialize it once per enum:
+
+	@code
+	enum LogLevel { LOG_ERROR, LOG_WARNING, LOG_INFO, LOG_DEBUG };
+
+	template<> struct enum_traits<LogLevel>
+	{
+		static constexpr enum_entry<LogLevel> entries[] = {
+			{ "error", LOG_ERROR }, { "warning", LOG_WARNING }, { "info", LOG_INFO }, { "debug", LOG_DEBUG } };
+	};
+	@endcode
+
+	Names are case-sensitive, like the names of getBool(). Several names may give one value.
+*/
+template<typename E> struct enum_traits;
+
+
+/**
+	@brief Building blocks of the perfect hash of CFGEnum, everything is constexpr.
+
+	Names are split into buckets by the low bits of their hash. Buckets are placed
+	from the biggest one, each gets a displacement which moves all its names to free
+	slots. The slot step is odd, so a displacement can reach every slot.
+*/
+template<typename E> struct enum_hash
+{
+	static constexpr std::size_t count = std::size(enum_traits<E>::entries);
+	static constexpr std::uint16_t empty = 0xFFFFU;
+
+	// Displacements go up to slot_count - 1, twice the names rounded up must fit in 16 bits.
+	static_assert(count > 0U && count <= 32768U, "Enum must have from 1 to 32768 names!");
+
+	static constexpr std::size_t round_up(const std::size_t value)
+	{
+		std::size_t result = 1U;
+		while (result < value) result <<= 1U;
+		return result;
+	}
+
+	static constexpr std::size_t bucket_count = round_up(count);
+	static constexpr std::size_t slot_count = round_up(count * 2U);
+
+	struct table_data
+	{
+		std::uint64_t seed;
+		std::uint16_t displacements[bucket_count];
+		std::uint16_t slots[slot_count];	// entry index or empty
+		bool valid;
+	};
+
+	static constexpr std::uint64_t hash_name(std::string_view name, const std::uint64_t seed)
+	{
+		std::uint64_t hash = 14695981039346656037ULL ^ seed;
+		for (const char chr : name) hash = (hash ^ static_cast<unsigned char>(chr)) * 1099511628211ULL;
+
+		hash ^= hash >> 33U;
+		hash *= 0xFF51AFD7ED558CCDULL;
+		hash ^= hash >> 33U;
+		return hash;
+	}
+
+	static constexpr std::size_t bucket_of(const std::uint64_t hash)
+	{
+		return static_cast<std::size_t>(hash & (bucket_count - 1U));
+	}
+
+	static constexpr std::size_t slot_of(const std::uint64_t hash, const std::size_t displacement)
+	{
+		return static_cast<std::size_t>(((hash >> 40U) + displacement * ((hash >> 20U) | 1U)) & (slot_count - 1U));
+	}
+
+	static constexpr bool place(table_data& table, const std::uint64_t* hashes, const std::size_t bucket)
+	{
+		for (std::size_t displacement = 0U; displacement < slot_count; ++displacement)
+		{
+			bool placed = true;
+			std::size_t i = 0U;
+
+			for (; i < count; ++i)
+			{
+				if (bucket_of(hashes[i]) != bucket) continue;
+
+				std::uint16_t& slot = table.slots[slot_of(hashes[i], displacement)];
+				if (slot != empty)
+				{
+					placed = false;
+					break;
+				}
+
+				slot = static_cast<std::uint16_t>(i);
+			}
+
+			if (placed)
+			{
+				table.displacements[bucket] = static_cast<std::uint16_t>(displacement);
+				return true;
+			}
+
+			// Take back the names of the bucket, which were placed before the collision.
+			for (std::size_t j = 0U; j < i; ++j)
+			{
+				if (bucket_of(hashes[j]) == bucket) table.slots[slot_of(hashes[j], displacement)] = empty;
+			}
+		}
+
+		return false;
+	}
+
+	static constexpr table_data build()
+	{
+		// Equal names collide with every seed, the loop gives up and the table is invalid.
+		for (std::uint64_t seed = 0U; seed < 64U; ++seed)
+		{
+			table_data table{};
+			table.seed = seed;
+			for (std::size_t i = 0U; i < slot_count; ++i) table.slots[i] = empty;
+
+			std::uint64_t hashes[count]{};
+			std::size_t sizes[bucket_count]{};
+			std::size_t biggest = 0U;
+
+			for (std::size_t i = 0U; i < count; ++i)
+			{
+				hashes[i] = hash_name(enum_traits<E>::entries[i].name, seed);
+
+				const std::size_t size = ++sizes[bucket_of(hashes[i])];
+				if (size > biggest) biggest = size;
+			}
+
+			bool placed = true;
+			for (std::size_t size = biggest; size > 0U && placed; --size)
+			{
+				for (std::size_t bucket = 0U; bucket < bucket_count && placed; ++bucket)
+				{
+					if (sizes[bucket] == size) placed = place(table, hashes, bucket);
+				}
+			}
+
+			if (placed)
+			{
+				table.valid = true;
+				return table;
+			}
+		}
+
+		return table_data{};
+	}
+};
+
+
+/**
+	@brief Compile-time perfect hash over the names of enum_traits<E>.
+
+	The table is built by the compiler, a lookup is one hash of the name, two table
+	reads and one comparison. Nothing is allocated.
+*/
+template<typename E> class CFGEnum
+{
+public:
+
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	/**
+		@brief Return index of the entry with this name, or npos.
+	*/
+	static constexpr std::size_t find(std::string_view name)
+	{
+		const std::uint64_t hash = hash_type::hash_name(name, _table.seed);
+		const std::size_t index = _table.slots[hash_type::slot_of(hash, _table.displacements[hash_type::bucket_of(hash)])];
+
+		return (index != hash_type::empty && enum_traits<E>::entries[index].name == name) ? index : npos;
+	}
+
+	/**
+		@brief Return entry by index from find().
+	*/
+	static constexpr const enum_entry<E>& entry(const std::size_t index)
+	{
+		return enum_traits<E>::entries[index];
+	}
+
+	/**
+		@brief Return number of names.
+	*/
+	static constexpr std::size_t size()
+	{
+		return hash_type::count;
+	}
+
+protected:
+
+	typedef enum_hash<E> hash_type;
+
+private:
+	static constexpr typename hash_type::table_data _table = hash_type::build();
+
+	static_assert(_table.valid, "Names of enum_traits must be unique!");
+
+};
+
+#endif
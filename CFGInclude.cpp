@@ -0,0 +1,150 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGInclude.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+
+CFGIncludeManager::CFGIncludeManager() :
+	_max_depth(32U)
+{
+}
+
+
+CFGIncludeManager::~CFGIncludeManager()
+{
+	this->reset();
+}
+
+
+void CFGIncludeManager::addSearchPath(const std::string& path)
+{
+	_search_paths.push_back(path);
+	_stat_cache.clear();
+}
+
+
+void CFGIncludeManager::clearSearchPaths()
+{
+	_search_paths.clear();
+	_stat_cache.clear();
+}
+
+
+const std::vector<std::string>& CFGIncludeManager::getSearchPaths() const
+{
+	return _search_paths;
+}
+
+
+void CFGIncludeManager::setMaxDepth(const std::size_t depth)
+{
+	_max_depth = depth;
+}
+
+
+const std::size_t CFGIncludeManager::getMaxDepth() const
+{
+	return _max_depth;
+}
+
+
+const std::string CFGIncludeManager::resolve(const std::string& name, const std::string& includer, const std::string& base_path)
+{
+	const std::filesystem::path path(name);
+
+	if (path.is_absolute()) return this->check(name);
+
+	const std::string& legacy = this->check(base_path + name);
+	if (!legacy.empty()) return legacy;
+
+	if (!includer.empty())
+	{
+		const std::string& sibling = this->check((std::filesystem::path(includer).parent_path() / path).string());
+		if (!sibling.empty()) return sibling;
+	}
+
+	for (const std::string& dir : _search_paths)
+	{
+		const std::string& found = this->check((std::filesystem::path(dir) / path).string());
+		if (!found.empty()) return found;
+	}
+
+	return std::string();
+}
+
+
+const bool CFGIncludeManager::enter(const std::string& path, std::string& error)
+{
+	if (std::find(_stack.begin(), _stack.end(), path) != _stack.end())
+	{
+		error = "Include cycle: ";
+		for (const std::string& file : _stack) error += file + " -> ";
+		error += path;
+		return false;
+	}
+
+	if (_stack.size() >= _max_depth)
+	{
+		error = "Include of \"" + path + "\" is deeper than " + std::to_string(_max_depth) + " levels!";
+		return false;
+	}
+
+	_stack.push_back(path);
+	return true;
+}
+
+
+void CFGIncludeManager::leave()
+{
+	if (!_stack.empty()) _stack.pop_back();
+}
+
+
+void CFGIncludeManager::reset()
+{
+	_stat_cache.clear();
+	_stack.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+const std::string& CFGIncludeManager::check(const std::string& candidate)
+{
+	std::unordered_map<std::string, std::string>::iterator it = _stat_cache.find(candidate);
+	if (it != _stat_cache.end()) return (*it).second;
+
+	std::error_code error;
+	std::string resolved;
+
+	if (std::filesystem::is_regular_file(candidate, error))
+	{
+		resolved = std::filesystem::weakly_canonical(candidate, error).string();
+		if (error) resolved = candidate;
+	}
+
+	return (*_stat_cache.emplace(candidate, resolved).first).second;
+}
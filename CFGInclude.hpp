@@ -0,0 +1,111 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_INCLUDE_HPP_
+#define _CFG_INCLUDE_HPP_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+
+/**
+	@brief Resolves #include names and tracks the chain of open includes.
+
+	A name is looked up in order: base path + name(the old behaviour), the directory
+	of the including file, then every search path. Results of file checks are
+	cached for the whole load, so a fragment included from many places is looked
+	up once. Resolved names are canonical paths and identify files for the parse
+	cache and for cycle detection.
+*/
+class CFGIncludeManager
+{
+public:
+
+	/**
+		@brief Constructor.
+	*/
+	CFGIncludeManager();
+
+	/**
+		@brief Destructor.
+	*/
+	virtual ~CFGIncludeManager();
+
+	/**
+		@brief Add directory to the end of search paths.
+	*/
+	void addSearchPath(const std::string& path);
+
+	/**
+		@brief Remove all search paths.
+	*/
+	void clearSearchPaths();
+
+	/**
+		@brief Return search paths in lookup order.
+	*/
+	const std::vector<std::string>& getSearchPaths() const;
+
+	/**
+		@brief Set how deep includes can be nested.
+	*/
+	void setMaxDepth(const std::size_t depth);
+
+	/**
+		@brief Return how deep includes can be nested.
+	*/
+	const std::size_t getMaxDepth() const;
+
+	/**
+		@brief Return canonical path of the included file. Empty string, if file isn't found.
+	*/
+	const std::string resolve(const std::string& name, const std::string& includer, const std::string& base_path);
+
+	/**
+		@brief Open include of the file. Return false with the reason, if it makes a cycle or is too deep.
+	*/
+	const bool enter(const std::string& path, std::string& error);
+
+	/**
+		@brief Close the last opened include.
+	*/
+	void leave();
+
+	/**
+		@brief Forget cached file checks and open includes. Called on every load.
+	*/
+	void reset();
+
+protected:
+
+	const std::string& check(const std::string& candidate);
+
+private:
+	std::vector<std::string> _search_paths;
+	std::unordered_map<std::string, std::string> _stat_cache; // candidate -> canonical path or empty string
+	std::vector<std::string> _stack;
+	std::size_t _max_depth;
+
+};
+
+#endif
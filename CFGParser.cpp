@@ -24,20 +24,55 @@
 #include <algorithm>
 #include <chrono>
 #include <future>
+#include <cstring>
+#include <charconv>
+#include <numeric>
+#include <functional>
+#include <thread>
+#include <iterator>
+#include <unordered_set>
+
+#ifdef _WIN32
+  #include <stdlib.h>
+  #define CFG_ENVIRON _environ
+#else
+  extern char** environ;
+  #define CFG_ENVIRON environ
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define CFG_SSE2
+#endif
+
+#ifdef __SSSE3__
+  #include <tmmintrin.h>
+  #define CFG_SSSE3
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define CFG_PREFETCH(address) __builtin_prefetch(address)
+#else
+  #define CFG_PREFETCH(address)
+#endif
 
 
 //#define DEBUG
 
 
-CFGParser::CFGParser(const std::string& cfg_file) : 
-	_ptype(KEY),
-	_line(0),
-	_cfg_base_path("")
+CFGParser::CFGParser(const std::string& cfg_file, const unsigned int options) : 
+	_buffer(0U, name_hash((options & CASE_INSENSITIVE) != 0U), name_equal((options & CASE_INSENSITIVE) != 0U), track(&_allocated)),
+	_overlay(0U, name_hash((options & CASE_INSENSITIVE) != 0U), name_equal((options & CASE_INSENSITIVE) != 0U), track(&_allocated)),
+	_cfg_base_path(""),
+	_options(options),
+	_symbols_hash(0U),
+	_generation(0U),
+	_schema(nullptr)
 {
 #ifdef DEBUG
 		auto& start = std::chrono::high_resolution_clock::now();
 #endif	
-	this->process_file(cfg_file);
+	this->load(cfg_file);
 #ifdef DEBUG
 		auto& finish = std::chrono::high_resolution_clock::now();
 		std::chrono::duration<double, std::milli> elapsed = finish - start;
@@ -46,407 +81,257 @@ CFGParser::CFGParser(const std::string& cfg_file) :
 }
 
 
+CFGParser::CFGParser(const unsigned int options) : 
+	_buffer(0U, name_hash((options & CASE_INSENSITIVE) != 0U), name_equal((options & CASE_INSENSITIVE) != 0U), track(&_allocated)),
+	_overlay(0U, name_hash((options & CASE_INSENSITIVE) != 0U), name_equal((options & CASE_INSENSITIVE) != 0U), track(&_allocated)),
+	_cfg_base_path(""),
+	_options(options),
+	_symbols_hash(0U),
+	_generation(0U),
+	_schema(nullptr)
+{
+}
+
+
+CFGParser::CFGParser(const CFGParser& other) :
+	_buffer(0U, other._buffer.hash_function(), other._buffer.key_eq(), track(&_allocated)),
+	_frozen(other._frozen),
+	_overlay(0U, other._overlay.hash_function(), other._overlay.key_eq(), track(&_allocated)),
+	_dependents(other._dependents),
+	_cfg_base_path(other._cfg_base_path),
+	_options(other._options),
+	_includes(other._includes),
+	_files(other._files),
+	_defines(other._defines),
+	_symbols_hash(0U),
+	_generation(0U),
+	_errors(other._errors),
+	_schema(other._schema)
+{
+	copy_sections(other._buffer, _buffer, true);
+	copy_sections(other._overlay, _overlay, false);
+	this->copy_order(other);
+}
+
+
 CFGParser::~CFGParser()
 {
 	_buffer.clear();
 }
 
 
-const bool CFGParser::getBool(const std::string& section, const std::string& key, const bool& default_value) const
+CFGParser& CFGParser::operator=(const CFGParser& other)
 {
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		if(str == "true" || str == "on" || str == "yes" || str == "1") //Of course, you can add you own values...
-		{
-			return true;
-		}
-		else if(str == "false" || str == "off" || str == "no" || str == "0")
-		{
-			return false;
-		}
-		else
-		{
-			std::cout << "Unknown boolean value!" << "\n}" << std::endl;
-			return default_value;
-		}
-	}
-	else
+	if (this != &other)
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
+		_buffer = section_map(0U, other._buffer.hash_function(), other._buffer.key_eq(), track(&_allocated));
+		copy_sections(other._buffer, _buffer, true);
+		_cfg_base_path = other._cfg_base_path;
+		_options = other._options;
+		_includes = other._includes;
+		_files = other._files;
+		_defines = other._defines;
+		_errors = other._errors;
+		_schema = other._schema;
+		_frozen = other._frozen;
+		_overlay = section_map(0U, other._overlay.hash_function(), other._overlay.key_eq(), track(&_allocated));
+		copy_sections(other._overlay, _overlay, false);
+		_dependents = other._dependents;
+		_generation++;
+		this->copy_order(other);
 	}
+
+	return *this;
 }
 
 
-const char CFGParser::getChar(const std::string& section, const std::string& key, const char& default_value) const
+const bool CFGParser::load(const std::string& cfg_file)
 {
-	char value = 0;
+	this->begin_load();
+	this->process_file(cfg_file);
 
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
+	return this->end_load();
+}
 
-		std::istringstream stream(str);
-		if (stream.fail() || stream.bad())
-		{
-			std::cout << "Can't convert string \"" << str << "\" to value! Return to default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else
-		{
-			stream >> value;
-			return value;
-		}
-	}
-	else
+
+std::future<bool> CFGParser::loadAsync(const std::string& cfg_file)
+{
+	return std::async(std::launch::async, [this, cfg_file]()
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+		return this->load(cfg_file);
+	});
 }
 
 
-const unsigned char CFGParser::getUChar(const std::string& section, const std::string& key, const unsigned char& default_value) const
+void CFGParser::addIncludePath(const std::string& path)
 {
-	unsigned char value = 0;
+	_includes.addSearchPath(path);
+}
 
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
 
-		std::istringstream stream(str);
-		if (stream.fail() || stream.bad())
-		{
-			std::cout << "Can't convert string \"" << str << "\" to value! Return to default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else
-		{
-			stream >> value;
-			return value;
-		}
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+void CFGParser::setMaxIncludeDepth(const std::size_t depth)
+{
+	_includes.setMaxDepth(depth);
 }
 
 
-const short CFGParser::getShort(const std::string& section, const std::string& key, const short& default_value) const
+void CFGParser::define(const std::string& name, const std::string& value)
 {
-	short value = 0;
+	_defines[name] = value;
+}
 
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
 
-		std::istringstream stream(str);
-		if (stream.fail() || stream.bad())
-		{
-			std::cout << "Can't convert string \"" << str << "\" to value! Return to default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else
-		{
-			stream >> value;
-			return value;
-		}
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+void CFGParser::undefine(const std::string& name)
+{
+	_defines.erase(name);
 }
 
 
-const unsigned short CFGParser::getUShort(const std::string& section, const std::string& key, const unsigned short& default_value) const
+const bool CFGParser::getBool(const std::string& section, const std::string& key, const bool& default_value) const
 {
-	unsigned short value = 0;
+	return this->get_value(section, key, default_value);
+}
 
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
 
-		std::istringstream stream(str);
-		if (stream.fail() || stream.bad())
-		{
-			std::cout << "Can't convert string \"" << str << "\" to value! Return to default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else
-		{
-			stream >> value;
-			return value;
-		}
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+const char CFGParser::getChar(const std::string& section, const std::string& key, const char& default_value) const
+{
+	return this->get_value(section, key, default_value);
 }
 
 
-const int CFGParser::getInt(const std::string& section, const std::string& key, const int& default_value) const
+const unsigned char CFGParser::getUChar(const std::string& section, const std::string& key, const unsigned char& default_value) const
 {
-	int value = 0;
+	return this->get_value(section, key, default_value);
+}
 
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return std::stoi(str);
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+
+const short CFGParser::getShort(const std::string& section, const std::string& key, const short& default_value) const
+{
+	return this->get_value(section, key, default_value);
 }
 
 
-const unsigned int CFGParser::getUInt(const std::string& section, const std::string& key, const unsigned int& default_value) const
+const unsigned short CFGParser::getUShort(const std::string& section, const std::string& key, const unsigned short& default_value) const
 {
-	unsigned int value = 0U;
+	return this->get_value(section, key, default_value);
+}
 
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
 
-		std::istringstream stream(str);
-		if (stream.fail() || stream.bad())
-		{
-			std::cout << "Can't convert string \"" << str << "\" to value! Return to default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else
-		{
-			stream >> value;
-			return value;
-		}
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+const int CFGParser::getInt(const std::string& section, const std::string& key, const int& default_value) const
+{
+	return this->get_value(section, key, default_value);
 }
 
 
-const long CFGParser::getLong(const std::string& section, const std::string& key, const long& default_value) const
+const unsigned int CFGParser::getUInt(const std::string& section, const std::string& key, const unsigned int& default_value) const
 {
-	long value = 0L;
+	return this->get_value(section, key, default_value);
+}
 
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return std::stol(str);
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+
+const long CFGParser::getLong(const std::string& section, const std::string& key, const long& default_value) const
+{
+	return this->get_value(section, key, default_value);
 }
 
 
 const unsigned long CFGParser::getULong(const std::string& section, const std::string& key, const unsigned long& default_value) const
 {
-	unsigned long value = 0UL;
-
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return std::stoul(str);
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+	return this->get_value(section, key, default_value);
 }
 
 
 const long long CFGParser::getLLong(const std::string& section, const std::string& key, const long long& default_value) const
 {
-	long long value = 0LL;
-
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return std::stoll(str);
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+	return this->get_value(section, key, default_value);
 }
 
 
 const unsigned long long CFGParser::getULLong(const std::string& section, const std::string& key, const unsigned long long& default_value) const
 {
-	unsigned long long value = 0ULL;
-
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return std::stoull(str);
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+	return this->get_value(section, key, default_value);
 }
 
 
 const float CFGParser::getFloat(const std::string& section, const std::string& key, const float& default_value) const
 {
-	float value = 0.0f;
-
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return std::stof(str);
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+	return this->get_value(section, key, default_value);
 }
 
 
 const double CFGParser::getDouble(const std::string& section, const std::string& key, const double& default_value) const
 {
-	double value = 0.0;
-
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return std::stod(str);
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+	return this->get_value(section, key, default_value);
 }
 
 
 const long double CFGParser::getLDouble(const std::string& section, const std::string& key, const long double& default_value) const
 {
-	long double value = 0.0;
-
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return std::stold(str);
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+	return this->get_value(section, key, default_value);
 }
 
 
 const Vec2 CFGParser::getVec2f(const std::string& section, const std::string& key, const Vec2& default_value) const
 {
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
+	return this->get_value(section, key, default_value);
+}
 
-		for (std::size_t i = 0U; i < str.size(); ++i)
-		{
-			const char& ch = str[i];
-			switch (ch)
-			{
-				case ',':
-					vec.push_back(svalue);
-					svalue.clear();
-				break;
 
-				default:
-					svalue += ch;
-				break;
-			}
-		}
+const Vec2i CFGParser::getVec2i(const std::string& section, const std::string& key, const Vec2i& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
 
-		vec.push_back(svalue);
-		svalue.clear();
 
-		const std::size_t vsize = vec.size();
+const Vec2u CFGParser::getVec2u(const std::string& section, const std::string& key, const Vec2u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
 
-		if (vsize < 2U)
-		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 2 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else if (vsize > 2U)
-		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 2 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else
-		{
-			return Vec2(std::stof(vec[0]), std::stof(vec[1]));
-		}
-	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
+
+const Vec3 CFGParser::getVec3f(const std::string& section, const std::string& key, const Vec3& default_value) const
+{
+	return this->get_value(section, key, default_value);
 }
 
 
-const Vec2i CFGParser::getVec2i(const std::string& section, const std::string& key, const Vec2i& default_value) const
+const Vec3i CFGParser::getVec3i(const std::string& section, const std::string& key, const Vec3i& default_value) const
 {
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
+	return this->get_value(section, key, default_value);
+}
 
-		for (std::size_t i = 0U; i < str.size(); ++i)
-		{
-			const char& ch = str[i];
-			switch (ch)
-			{
-			case ',':
-				vec.push_back(svalue);
-				svalue.clear();
-				break;
 
-			default:
-				svalue += ch;
-				break;
-			}
-		}
+const Vec3u CFGParser::getVec3u(const std::string& section, const std::string& key, const Vec3u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
 
-		const std::size_t vsize = vec.size();
 
-		if (vsize < 2U)
-		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 2 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else if (vsize > 2U)
-		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 2 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else
-		{
-			return Vec2i(std::stoi(vec[0]), std::stoi(vec[1]));
-		}
+const Vec4 CFGParser::getVec4f(const std::string& section, const std::string& key, const Vec4& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec4i CFGParser::getVec4i(const std::string& section, const std::string& key, const Vec4i& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec4u CFGParser::getVec4u(const std::string& section, const std::string& key, const Vec4u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const std::string& CFGParser::getString(const std::string& section, const std::string& key, const std::string& default_value) const
+{
+	const value_data* data = this->find_value(section, key);
+	if (data)
+	{
+		const std::string& str = this->value_of(*data, section);
+		return str;
 	}
 	else
 	{
@@ -456,698 +341,2604 @@ const Vec2i CFGParser::getVec2i(const std::string& section, const std::string& k
 }
 
 
-const Vec2u CFGParser::getVec2u(const std::string& section, const std::string& key, const Vec2u& default_value) const
+const std::size_t CFGParser::getVectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, float* const* components) const
+{
+	return this->get_vectors(section, keys, count, size, components);
+}
+
+
+const std::size_t CFGParser::getVectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, double* const* components) const
+{
+	return this->get_vectors(section, keys, count, size, components);
+}
+
+
+const std::size_t CFGParser::getVectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, int* const* components) const
+{
+	return this->get_vectors(section, keys, count, size, components);
+}
+
+
+const std::size_t CFGParser::getVectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, unsigned int* const* components) const
+{
+	return this->get_vectors(section, keys, count, size, components);
+}
+
+
+const CFGParser::blob_data CFGParser::getBlob(const std::string& section, const std::string& key) const
+{
+	const value_data* data = this->find_value(section, key);
+	if (!data)
+	{
+		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+		return blob_data{ nullptr, 0U };
+	}
+
+	const blob_cache* blob = data->blob.load(std::memory_order_acquire);
+	if (!blob)
+	{
+		std::unique_ptr<blob_cache> decoded(new blob_cache());
+		const std::string_view text(this->value_of(*data, section));
+		decoded->decoded = (text.compare(0U, 4U, "hex:") == 0) ? decode_hex(text.substr(4U), decoded->bytes) :
+			decode_base64((text.compare(0U, 7U, "base64:") == 0) ? text.substr(7U) : text, decoded->bytes);
+
+		if (!decoded->decoded)
+		{
+			std::vector<unsigned char>().swap(decoded->bytes);
+			std::cout << "Can't decode binary value of section \"" << section << "\" key \"" << key << "\"!" << "\n}" << std::endl;
+		}
+
+		// Another reader may have published its result first, then that one is used.
+		const blob_cache* expected = nullptr;
+		if (data->blob.compare_exchange_strong(expected, decoded.get(), std::memory_order_acq_rel, std::memory_order_acquire)) blob = decoded.release();
+		else blob = expected;
+	}
+
+	return blob->decoded ? blob_data{ blob->bytes.data(), blob->bytes.size() } : blob_data{ nullptr, 0U };
+}
+
+
+const std::size_t CFGParser::getValues(value_query* queries, const std::size_t count) const
+{
+	std::vector<const value_data*> found(count, nullptr);
+
+	if (_frozen && !_frozen->slots.empty())
+	{
+		const frozen_table& table = *_frozen;
+		const bool fold = (_options & CASE_INSENSITIVE) != 0U;
+		std::vector<std::uint64_t> hashes(count);
+		std::vector<std::size_t> positions(count);
+
+		for (std::size_t i = 0U; i < count; ++i)
+		{
+			const value_query& query = queries[i];
+			hashes[i] = hash_name(query.key.data(), query.key.size(), hash_name(query.section.data(), query.section.size(), table.seed, fold), fold);
+			CFG_PREFETCH(&table.displacement[(hashes[i] >> 32U) % table.displacement.size()]);
+		}
+
+		for (std::size_t i = 0U; i < count; ++i)
+		{
+			positions[i] = frozen_position(hashes[i], table.displacement[(hashes[i] >> 32U) % table.displacement.size()], table.slots.size());
+			CFG_PREFETCH(&table.slots[positions[i]]);
+		}
+
+		for (std::size_t i = 0U; i < count; ++i)
+		{
+			const frozen_slot& slot = table.slots[positions[i]];
+			if (slot.fingerprint == hashes[i]) found[i] = slot.data;
+		}
+	}
+	else if (!_frozen)
+	{
+		// Node layout of std::unordered_map is hidden, so here only the section lookups are shared.
+		std::vector<std::size_t> sorted(count);
+		std::iota(sorted.begin(), sorted.end(), static_cast<std::size_t>(0U));
+		std::stable_sort(sorted.begin(), sorted.end(), [queries](const std::size_t a, const std::size_t b)
+		{
+			return queries[a].section < queries[b].section;
+		});
+
+		const std::string* name = nullptr;
+		const section_data* current = nullptr;
+
+		for (const std::size_t i : sorted)
+		{
+			const value_query& query = queries[i];
+			if (!name || *name != query.section)
+			{
+				const section_map::const_iterator it = _buffer.find(query.section);
+				current = (it != _buffer.end()) ? (*it).second.get() : nullptr;
+				name = &query.section;
+			}
+
+			if (current)
+			{
+				const value_map::const_iterator itr = current->values.find(query.key);
+				if (itr != current->values.end()) found[i] = &(*itr).second;
+			}
+		}
+	}
+
+	if (!_overlay.empty())
+	{
+		for (std::size_t i = 0U; i < count; ++i)
+		{
+			const section_map::const_iterator it = _overlay.find(queries[i].section);
+			if (it == _overlay.end()) continue;
+
+			const value_map::const_iterator itr = (*it).second->values.find(queries[i].key);
+			if (itr != (*it).second->values.end()) found[i] = &(*itr).second;
+		}
+	}
+
+	std::size_t written = 0U;
+	for (std::size_t i = 0U; i < count; ++i)
+	{
+		value_query& query = queries[i];
+		query.found = false;
+
+		if (!found[i])
+		{
+			std::cout << "Section \"" << query.section << "\" or key \"" << query.key << "\" doesn't exist!" << "\n}" << std::endl;
+			continue;
+		}
+
+		const std::string& str = this->value_of(*found[i], query.section);
+		if (convert_to(str, query.type, query.value))
+		{
+			query.found = true;
+			written++;
+		}
+		else
+		{
+			std::cout << "Can't convert string \"" << str << "\" of section \"" << query.section << "\" key \"" << query.key << "\" to value! Return to default value..." << "\n}" << std::endl;
+		}
+	}
+
+	return written;
+}
+
+
+void CFGParser::setSchema(const CFGSchema* schema)
+{
+	_schema = schema;
+	if (_schema) this->parse_units(*_schema);
+}
+
+
+const std::size_t CFGParser::validate(const CFGSchema& schema)
+{
+	std::vector<bool> seen_sections(schema._sections.size(), false);
+	std::vector<bool> seen_keys(schema._keys.size(), false);
+	std::size_t violations = 0U;
+	std::string problem;
+
+	const auto check_key = [&](const std::size_t section, const std::string& name, const value_map::value_type& val)
+	{
+		const std::size_t key = schema.find_key(section, val.first);
+		if (key == CFGSchema::npos)
+		{
+			if (schema._sections[section].closed)
+			{
+				this->report(val.second, "Unknown key \"" + val.first + "\" in closed section \"" + name + "\"!");
+				violations++;
+			}
+
+			return;
+		}
+
+		seen_keys[key] = true;
+		if (!this->check_value(schema._keys[key], val.second, name, problem))
+		{
+			this->report(val.second, "Key \"" + val.first + "\" of section \"" + name + "\" " + problem);
+			violations++;
+		}
+	};
+
+	for (const section_map::value_type* sec : _order)
+	{
+		const std::size_t section = schema.find_section(sec->first);
+		if (section == CFGSchema::npos) continue;
+
+		seen_sections[section] = true;
+		const section_map::const_iterator over = _overlay.find(sec->first);
+
+		for (const value_map::value_type* val : sec->second->order)
+		{
+			// The override is what getters return, it's checked with the overlay.
+			if (over != _overlay.end() && (*over).second->values.count(val->first) != 0U) continue;
+
+			check_key(section, sec->first, *val);
+		}
+	}
+
+	for (const section_map::value_type& sec : _overlay)
+	{
+		const std::size_t section = schema.find_section(sec.first);
+		if (section == CFGSchema::npos) continue;
+
+		seen_sections[section] = true;
+		for (const value_map::value_type& val : sec.second->values) check_key(section, sec.first, val);
+	}
+
+	for (std::size_t i = 0U; i < schema._sections.size(); ++i)
+	{
+		const CFGSchema::section_rule& sec = schema._sections[i];
+		if (sec.required && !seen_sections[i])
+		{
+			this->report(0U, 0U, "Required section \"" + sec.name + "\" is missing!");
+			violations++;
+			continue;
+		}
+
+		if (sec.pattern) continue;
+
+		for (const std::pair<const std::string, std::size_t>& key : sec.keys)
+		{
+			if (!schema._keys[key.second].required || seen_keys[key.second]) continue;
+
+			this->report(0U, 0U, "Required key \"" + schema._keys[key.second].name + "\" of section \"" + sec.name + "\" is missing!");
+			violations++;
+		}
+	}
+
+	return violations;
+}
+
+
+const CFGParser::memory_data CFGParser::getMemoryUsage() const
+{
+	memory_data memory;
+	memory.strings = memory.buckets = memory.nodes = memory.sections = memory.caches = memory.indexes = memory.shared = 0U;
+#ifdef CFG_TRACK_MEMORY
+	memory.exact = true;
+#else
+	memory.exact = false;
+#endif
+
+	memory.files.resize(_files.size());
+	for (std::size_t i = 0U; i < _files.size(); ++i)
+	{
+		memory.files[i].first = _files[i];
+		memory.files[i].second = 0U;
+		memory.strings += string_bytes(_files[i]);
+	}
+
+#ifdef CFG_TRACK_MEMORY
+	memory.buckets += _allocated.buckets;
+	memory.nodes += _allocated.nodes;
+#else
+	memory.buckets += bucket_bytes(_buffer) + bucket_bytes(_overlay);
+	memory.nodes += node_bytes(_buffer) + node_bytes(_overlay);
+#endif
+
+	for (const section_map* sections : { &_buffer, &_overlay })
+	{
+		for (const section_map::value_type& sec : *sections)
+		{
+			const std::size_t bytes = this->section_bytes(sec.first, *sec.second, memory);
+			if (sec.second.use_count() > 1) memory.shared += bytes;
+		}
+	}
+
+	memory.indexes += _order.capacity() * sizeof(_order[0]) + _section_index.getMemoryUsage() + _key_index.getMemoryUsage();
+
+	if (_dependents)
+	{
+		memory.indexes += bucket_bytes(*_dependents) + node_bytes(*_dependents);
+		for (const dependency_map::value_type& dep : *_dependents)
+		{
+			memory.indexes += string_bytes(dep.first) + dep.second.capacity() * sizeof(std::string);
+			for (const std::string& name : dep.second) memory.indexes += string_bytes(name);
+		}
+	}
+
+	if (_frozen)
+	{
+		memory.indexes += sizeof(frozen_table) + _frozen->displacement.capacity() * sizeof(std::uint64_t) + _frozen->slots.capacity() * sizeof(frozen_slot) +
+			_frozen->sections.capacity() * sizeof(section_ptr);
+	}
+
+	memory.total = memory.strings + memory.buckets + memory.nodes + memory.sections + memory.caches + memory.indexes;
+	return memory;
+}
+
+
+const std::size_t CFGParser::getSectionNum() const
+{
+	return _buffer.size();
+}
+
+
+const std::size_t CFGParser::getConfigNum(const std::string& section) const
+{
+	if(this->isSectionExist(section))
+	{
+		return _buffer.at(section)->values.size();
+	}
+	else
+	{
+		std::cout << "Section \"" << section << "\" doesn't exist!" << "\n}" << std::endl;
+		return 0U;
+	}
+}
+
+
+void CFGParser::setBaseConfigPath(const std::string& path)
+{
+	_cfg_base_path = path;
+}
+
+
+const std::string& CFGParser::getBaseConfigPath() const
+{
+	return _cfg_base_path;
+}
+
+
+const CFGParser::key_range CFGParser::keys(const std::string& section) const
+{
+	const section_map::const_iterator it = _buffer.find(section);
+	if (it != _buffer.end())
+	{
+		const std::vector<const value_map::value_type*>& order = (*it).second->order;
+		return key_range(order.data(), order.data() + order.size());
+	}
+	else
+	{
+		return key_range();
+	}
+}
+
+
+const bool CFGParser::section_view::exists() const
+{
+	if (!_parser) return false;
+	if (_generation != _parser->_generation) this->refresh();
+
+	return (_values || _overlay) ? true : false;
+}
+
+
+const std::string& CFGParser::section_view::getString(const std::string& key, const std::string& default_value) const
+{
+	const value_data* data = this->find(key);
+	if (data)
+	{
+		return _parser->value_of(*data, _name);
+	}
+	else
+	{
+		std::cout << "Section \"" << _name << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+		return default_value;
+	}
+}
+
+
+const CFGParser::value_data* CFGParser::section_view::find(const std::string& key) const
+{
+	if (!_parser) return nullptr;
+	if (_generation != _parser->_generation) this->refresh();
+
+	if (_overlay)
+	{
+		const value_map::const_iterator it = _overlay->values.find(key);
+		if (it != _overlay->values.end()) return &(*it).second;
+	}
+
+	if (_parser->_frozen) return _parser->find_frozen(hash_name(key.data(), key.size(), _seed, (_parser->_options & CASE_INSENSITIVE) != 0U));
+
+	if (!_values) return nullptr;
+
+	const value_map::const_iterator it = _values->values.find(key);
+	return (it != _values->values.end()) ? &(*it).second : nullptr;
+}
+
+
+void CFGParser::section_view::refresh() const
+{
+	_generation = _parser->_generation;
+	_values = nullptr;
+	_overlay = nullptr;
+	_seed = 0U;
+
+	if (!_parser->_overlay.empty())
+	{
+		const section_map::const_iterator it = _parser->_overlay.find(_name);
+		if (it != _parser->_overlay.end()) _overlay = (*it).second.get();
+	}
+
+	if (_parser->_frozen) _seed = hash_name(_name.data(), _name.size(), _parser->_frozen->seed, (_parser->_options & CASE_INSENSITIVE) != 0U);
+
+	const section_map::const_iterator it = _parser->_buffer.find(_name);
+	if (it != _parser->_buffer.end()) _values = (*it).second.get();
+}
+
+
+const bool CFGParser::freeze()
+{
+	std::size_t count = 0U;
+	for (const section_map::value_type* sec : _order) count += sec->second->order.size();
+
+	const bool fold = (_options & CASE_INSENSITIVE) != 0U;
+	std::shared_ptr<frozen_table> table = std::make_shared<frozen_table>();
+	table->seed = 0U;
+
+	if (count == 0U)
+	{
+		_frozen = table;
+		_generation++;
+		return true;
+	}
+
+	std::vector<std::uint64_t> hashes(count);
+	std::vector<const value_data*> values(count);
+	std::vector<std::size_t> positions(count);
+
+	for (std::uint64_t attempt = 0U; attempt < 8U; ++attempt)
+	{
+		table->seed = hash_mix(attempt + 0x9E3779B97F4A7C15ULL);
+
+		std::size_t index = 0U;
+		for (const section_map::value_type* sec : _order)
+		{
+			const std::uint64_t section_hash = hash_name(sec->first.data(), sec->first.size(), table->seed, fold);
+			for (const value_map::value_type* val : sec->second->order)
+			{
+				hashes[index] = hash_name(val->first.data(), val->first.size(), section_hash, fold);
+				values[index] = &val->second;
+				index++;
+			}
+		}
+
+		if (place_hashes(hashes, table->displacement, positions))
+		{
+			table->slots.resize(count);
+			for (std::size_t i = 0U; i < count; ++i)
+			{
+				frozen_slot& slot = table->slots[positions[i]];
+				slot.fingerprint = hashes[i];
+				slot.data = values[i];
+			}
+
+			table->sections.reserve(_order.size());
+			for (const section_map::value_type* sec : _order) table->sections.push_back(sec->second);
+
+			_frozen = table;
+			_generation++;
+			return true;
+		}
+	}
+
+	std::cout << "Can't build frozen lookup table!" << "\n}" << std::endl;
+	return false;
+}
+
+
+const std::vector<std::string_view> CFGParser::findSections(const std::string& pattern) const
+{
+	if ((_options & NAME_INDEX) == 0U) return this->scan_names("", pattern, false);
+
+	std::vector<std::string_view> result;
+	_section_index.findGlob("", this->fold_name(pattern), result);
+	return result;
+}
+
+
+const std::vector<std::string_view> CFGParser::findSectionsByPrefix(const std::string& prefix) const
+{
+	if ((_options & NAME_INDEX) == 0U) return this->scan_names("", prefix, true);
+
+	std::vector<std::string_view> result;
+	_section_index.findPrefix("", this->fold_name(prefix), result);
+	return result;
+}
+
+
+const std::vector<std::string_view> CFGParser::findKeys(const std::string& section, const std::string& pattern) const
+{
+	if ((_options & NAME_INDEX) == 0U) return this->scan_names(section, pattern, false);
+
+	std::vector<std::string_view> result;
+	_key_index.findGlob(this->fold_name(section) + '\0', this->fold_name(pattern), result);
+	return result;
+}
+
+
+const std::vector<std::string_view> CFGParser::findKeysByPrefix(const std::string& section, const std::string& prefix) const
+{
+	if ((_options & NAME_INDEX) == 0U) return this->scan_names(section, prefix, true);
+
+	std::vector<std::string_view> result;
+	_key_index.findPrefix(this->fold_name(section) + '\0', this->fold_name(prefix), result);
+	return result;
+}
+
+
+const bool CFGParser::set(const std::string& section, const std::string& key, const std::string& value)
+{
+	if (_frozen)
+	{
+		std::cout << "Frozen config can't be changed, value of section \"" << section << "\" key \"" << key << "\" isn't set!" << "\n}" << std::endl;
+		return false;
+	}
+
+	const char* source = "set";
+	std::vector<std::string>::iterator it = std::find(_files.begin(), _files.end(), source);
+	if (it == _files.end()) it = _files.insert(_files.end(), source);
+
+	value_data data;
+	data.value = value;
+	data.line = 0U;
+	data.file = static_cast<std::uint32_t>(it - _files.begin());
+	this->insert_value(section, key, data);
+	this->update_values({ this->fold_name(section) + '\0' + this->fold_name(key) });
+
+	_generation++;
+	return true;
+}
+
+
+void CFGParser::setOverride(const std::string& section, const std::string& key, const std::string& value)
+{
+	this->update_values({ this->set_override(section, key, value) });
+	_generation++;
+}
+
+
+const std::size_t CFGParser::loadEnvironmentOverrides(const std::string& prefix)
+{
+	std::vector<std::string> names;
+
+	for (char** env = CFG_ENVIRON; env && *env; ++env)
+	{
+		const std::string var = *env;
+		if (var.compare(0U, prefix.size(), prefix) != 0) continue;
+
+		const std::size_t equal = var.find('=', prefix.size());
+		const std::size_t split = var.find("__", prefix.size());
+		if (equal == std::string::npos || split == std::string::npos || split > equal) continue;
+
+		const std::string section = var.substr(prefix.size(), split - prefix.size());
+		const std::string key = var.substr(split + 2U, equal - split - 2U);
+		if (section.empty() || key.empty()) continue;
+
+		names.push_back(this->set_override(section, key, var.substr(equal + 1U)));
+	}
+
+	if (!names.empty())
+	{
+		this->update_values(names);
+		_generation++;
+	}
+
+	return names.size();
+}
+
+
+const std::size_t CFGParser::loadArgumentOverrides(const int argc, const char* const* argv)
+{
+	std::vector<std::string> names;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--set" && i + 1 < argc) arg = argv[++i];
+		else if (arg.compare(0U, 6U, "--set=") == 0) arg.erase(0U, 6U);
+		else continue;
+
+		const std::size_t equal = arg.find('=');
+		const std::size_t dot = arg.rfind('.', equal);
+		if (equal == std::string::npos || dot == std::string::npos || dot == 0U || dot + 1U == equal)
+		{
+			std::cout << "Wrong override \"" << arg << "\", expected section.key=value!" << "\n}" << std::endl;
+			continue;
+		}
+
+		names.push_back(this->set_override(arg.substr(0U, dot), arg.substr(dot + 1U, equal - dot - 1U), arg.substr(equal + 1U)));
+	}
+
+	if (!names.empty())
+	{
+		this->update_values(names);
+		_generation++;
+	}
+
+	return names.size();
+}
+
+
+void CFGParser::clearOverrides()
+{
+	std::vector<std::string> names;
+	for (const section_map::value_type& sec : _overlay)
+	{
+		for (const value_map::value_type& val : sec.second->values) names.push_back(sec.first + '\0' + val.first);
+	}
+
+	_overlay.clear();
+	this->update_values(names);
+	_generation++;
+}
+
+
+const std::size_t CFGParser::getOverrideNum() const
+{
+	std::size_t count = 0U;
+	for (const section_map::value_type& sec : _overlay) count += sec.second->values.size();
+
+	return count;
+}
+
+
+void CFGParser::debug()
+{
+	for (const section_entry& section : this->sections())
+	{
+		std::cout << "[" << section.name << "]" << std::endl;
+		for (const key_entry& entry : section.keys)
+		{
+			std::cout << entry.key << " = " << entry.value << std::endl;
+		}
+		
+		std::cout << "\n" << std::endl;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+template<typename T> const bool CFGParser::convert_number(std::string_view str, T& value)
+{
+	while (!str.empty() && (str[0] == ' ' || str[0] == '\t')) str.remove_prefix(1U);
+	if (!str.empty() && str[0] == '+') str.remove_prefix(1U);
+
+	// Like std::stoi, the number may be followed by anything.
+	if constexpr (std::is_integral<T>::value)
+	{
+		if (str.size() > 2U && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+		{
+			const std::from_chars_result result = std::from_chars(str.data() + 2U, str.data() + str.size(), value, 16);
+			return (result.ec == std::errc()) ? true : false;
+		}
+	}
+
+	const std::from_chars_result result = std::from_chars(str.data(), str.data() + str.size(), value);
+	return (result.ec == std::errc()) ? true : false;
+}
+
+
+template<typename T> const bool CFGParser::convert_components(std::string_view str, T* values, const std::size_t count)
+{
+	for (std::size_t i = 0U; i < count; ++i)
+	{
+		const std::size_t comma = str.find(',');
+		if ((comma == std::string_view::npos) != (i + 1U == count)) return false;
+
+		if (!convert_number(str.substr(0U, comma), values[i])) return false;
+		if (comma != std::string_view::npos) str.remove_prefix(comma + 1U);
+	}
+
+	return true;
+}
+
+
+const bool CFGParser::parse_unit(std::string_view str, const unit_suffix* suffixes, const std::size_t count, double& value)
+{
+	while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) str.remove_prefix(1U);
+	while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) str.remove_suffix(1U);
+	if (!str.empty() && str[0] == '+') str.remove_prefix(1U);
+
+	const char* end;
+	if (str.size() > 2U && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+	{
+		std::uint64_t number;
+		const std::from_chars_result result = std::from_chars(str.data() + 2U, str.data() + str.size(), number, 16);
+		if (result.ec != std::errc()) return false;
+
+		value = static_cast<double>(number);
+		end = result.ptr;
+	}
+	else
+	{
+		const std::from_chars_result result = std::from_chars(str.data(), str.data() + str.size(), value);
+		if (result.ec != std::errc()) return false;
+
+		end = result.ptr;
+	}
+
+	std::string_view suffix(end, static_cast<std::size_t>(str.data() + str.size() - end));
+	while (!suffix.empty() && (suffix.front() == ' ' || suffix.front() == '\t')) suffix.remove_prefix(1U);
+
+	for (std::size_t i = 0U; i < count; ++i)
+	{
+		if (suffix == suffixes[i].name)
+		{
+			value *= suffixes[i].scale;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+const bool CFGParser::parse_unit(std::string_view str, const unit_suffix* suffixes, const std::size_t count, std::uint64_t& value)
+{
+	while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) str.remove_prefix(1U);
+	while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) str.remove_suffix(1U);
+	if (!str.empty() && str[0] == '+') str.remove_prefix(1U);
+
+	const bool hex = str.size() > 2U && str[0] == '0' && (str[1] == 'x' || str[1] == 'X');
+	std::uint64_t number;
+	const std::from_chars_result result = std::from_chars(str.data() + (hex ? 2U : 0U), str.data() + str.size(), number, hex ? 16 : 10);
+	if (result.ec != std::errc()) return false;
+
+	std::string_view suffix(result.ptr, static_cast<std::size_t>(str.data() + str.size() - result.ptr));
+	while (!suffix.empty() && (suffix.front() == ' ' || suffix.front() == '\t')) suffix.remove_prefix(1U);
+
+	// Fractions, exponents and fractional factors are left to the double parser.
+	for (std::size_t i = 0U; i < count; ++i)
+	{
+		if (suffix != suffixes[i].name) continue;
+
+		const double scale = suffixes[i].scale;
+		if (!(scale >= 1.0 && scale < 18446744073709551616.0) || scale != std::floor(scale)) return false;
+
+		const std::uint64_t factor = static_cast<std::uint64_t>(scale);
+		if (number > std::numeric_limits<std::uint64_t>::max() / factor) return false;
+
+		value = number * factor;
+		return true;
+	}
+
+	return false;
+}
+
+
+const std::size_t CFGParser::string_bytes(const std::string& str)
+{
+	// Short strings live inside the string object.
+	const char* object = reinterpret_cast<const char*>(&str);
+	const bool inside = !std::less<const char*>()(str.data(), object) && std::less<const char*>()(str.data(), object + sizeof(std::string));
+
+	return inside ? 0U : str.capacity() + 1U;
+}
+
+
+template<typename M> const std::size_t CFGParser::bucket_bytes(const M& map)
+{
+	// A table with one bucket keeps it inside the object.
+	return (map.bucket_count() > 1U) ? map.bucket_count() * sizeof(void*) : 0U;
+}
+
+
+template<typename M> const std::size_t CFGParser::node_bytes(const M& map)
+{
+	// Next pointer, element and cached hash.
+	return map.size() * (sizeof(void*) + sizeof(typename M::value_type) + sizeof(std::size_t));
+}
+
+
+const std::size_t CFGParser::section_bytes(const std::string& name, const section_data& sec, memory_data& memory) const
+{
+	const std::size_t node = sizeof(void*) + sizeof(value_map::value_type) + sizeof(std::size_t);
+	std::size_t bytes = sizeof(section_data) + sec.order.capacity() * sizeof(sec.order[0]) + string_bytes(name);
+	memory.sections += bytes;
+
+#ifdef CFG_TRACK_MEMORY
+	memory.buckets += sec.allocated.buckets;
+	memory.nodes += sec.allocated.nodes;
+	bytes += sec.allocated.buckets + sec.allocated.nodes;
+#else
+	memory.buckets += bucket_bytes(sec.values);
+	memory.nodes += node_bytes(sec.values);
+	bytes += bucket_bytes(sec.values) + node_bytes(sec.values);
+#endif
+
+	for (const value_map::value_type& val : sec.values)
+	{
+		const std::size_t strings = string_bytes(val.first) + string_bytes(val.second.value);
+		memory.strings += strings;
+		bytes += strings;
+
+		std::size_t cache = 0U;
+		if (val.second.cache) cache = sizeof(value_cache) + string_bytes(val.second.cache->expanded);
+
+		const blob_cache* blob = val.second.blob.load(std::memory_order_acquire);
+		if (blob) cache += sizeof(blob_cache) + blob->bytes.capacity();
+		memory.caches += cache;
+		bytes += cache;
+
+		if (val.second.file < memory.files.size()) memory.files[val.second.file].second += node + strings;
+	}
+
+	return bytes;
+}
+
+
+const bool CFGParser::check_value(const CFGSchema::key_rule& rule, const value_data& data, const std::string& section, std::string& problem) const
+{
+	const std::string& str = this->value_of(data, section);
+	double numbers[4] = { 0.0, 0.0, 0.0, 0.0 };
+	std::size_t count = 1U;
+	bool valid = true;
+
+	switch (rule.type)
+	{
+		case CFGSchema::TYPE_ANY: return true;
+		case CFGSchema::TYPE_BOOL: { bool value; valid = convert(str, value); count = 0U; } break;
+		case CFGSchema::TYPE_INT: { long long value; valid = convert(str, value); numbers[0] = static_cast<double>(value); } break;
+		case CFGSchema::TYPE_UINT: { unsigned long long value; valid = convert(str, value); numbers[0] = static_cast<double>(value); } break;
+		case CFGSchema::TYPE_FLOAT: valid = convert(str, numbers[0]); break;
+		case CFGSchema::TYPE_STRING: numbers[0] = static_cast<double>(str.size()); break;
+		case CFGSchema::TYPE_SIZE: { std::uint64_t value = 0U; valid = this->unit_value<unit_size>(data, section, value); numbers[0] = static_cast<double>(value); } break;
+		case CFGSchema::TYPE_DURATION: valid = this->unit_value<unit_duration>(data, section, numbers[0]); break;
+		case CFGSchema::TYPE_PERCENT: valid = this->unit_value<unit_percent>(data, section, numbers[0]); break;
+		case CFGSchema::TYPE_VEC2: count = 2U; valid = convert_vector(str, numbers, count); break;
+		case CFGSchema::TYPE_VEC3: count = 3U; valid = convert_vector(str, numbers, count); break;
+		case CFGSchema::TYPE_VEC4: count = 4U; valid = convert_vector(str, numbers, count); break;
+		case CFGSchema::TYPE_CHOICE: valid = (rule.choices.count(str) != 0U); count = 0U; break;
+	}
+
+	if (!valid)
+	{
+		static const char* const names[] = { "anything", "a boolean", "an integer", "an unsigned integer", "a number", "a string",
+			"a size", "a duration", "a percentage", "a 2-component vector", "a 3-component vector", "a 4-component vector", "one of the allowed names" };
+
+		problem = "has value \"" + str + "\", which isn't " + names[rule.type] + "!";
+		return false;
+	}
+
+	if (rule.ranged)
+	{
+		for (std::size_t i = 0U; i < count; ++i)
+		{
+			if (numbers[i] >= rule.min && numbers[i] <= rule.max) continue;
+
+			std::ostringstream stream;
+			stream << "has value \"" << str << "\" out of range [" << rule.min << ", " << rule.max << "]!";
+			problem = stream.str();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+const bool CFGParser::convert_vector(std::string_view str, float* values, const std::size_t count) { return convert_components(str, values, count); }
+const bool CFGParser::convert_vector(std::string_view str, double* values, const std::size_t count) { return convert_components(str, values, count); }
+const bool CFGParser::convert_vector(std::string_view str, int* values, const std::size_t count) { return convert_components(str, values, count); }
+const bool CFGParser::convert_vector(std::string_view str, unsigned int* values, const std::size_t count) { return convert_components(str, values, count); }
+
+
+template<typename T> const std::size_t CFGParser::get_vectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, T* const* components) const
+{
+	if (size == 0U || size > 4U)
+	{
+		std::cout << "Vector size must be from 1 to 4!" << "\n}" << std::endl;
+		return 0U;
+	}
+
+	std::size_t written = 0U;
+	for (std::size_t i = 0U; i < count; ++i)
+	{
+		const value_data* data = this->find_value(section, keys[i]);
+		if (!data)
+		{
+			std::cout << "Section \"" << section << "\" or key \"" << keys[i] << "\" doesn't exist!" << "\n}" << std::endl;
+			continue;
+		}
+
+		const std::string& str = this->value_of(*data, section);
+		T value[4];
+		if (!convert_components(str, value, size))
+		{
+			std::cout << "Can't convert string \"" << str << "\" of section \"" << section << "\" key \"" << keys[i] << "\" to value! Return to default value..." << "\n}" << std::endl;
+			continue;
+		}
+
+		// Scattered per component, so a broken value leaves its column untouched.
+		for (std::size_t c = 0U; c < size; ++c) components[c][i] = value[c];
+		written++;
+	}
+
+	return written;
+}
+
+
+const bool CFGParser::convert_to(std::string_view str, const ValueType type, void* value)
+{
+	switch (type)
+	{
+		case TYPE_BOOL: return convert(str, *static_cast<bool*>(value));
+		case TYPE_CHAR: return convert(str, *static_cast<char*>(value));
+		case TYPE_UCHAR: return convert(str, *static_cast<unsigned char*>(value));
+		case TYPE_SHORT: return convert(str, *static_cast<short*>(value));
+		case TYPE_USHORT: return convert(str, *static_cast<unsigned short*>(value));
+		case TYPE_INT: return convert(str, *static_cast<int*>(value));
+		case TYPE_UINT: return convert(str, *static_cast<unsigned int*>(value));
+		case TYPE_LONG: return convert(str, *static_cast<long*>(value));
+		case TYPE_ULONG: return convert(str, *static_cast<unsigned long*>(value));
+		case TYPE_LLONG: return convert(str, *static_cast<long long*>(value));
+		case TYPE_ULLONG: return convert(str, *static_cast<unsigned long long*>(value));
+		case TYPE_FLOAT: return convert(str, *static_cast<float*>(value));
+		case TYPE_DOUBLE: return convert(str, *static_cast<double*>(value));
+		case TYPE_LDOUBLE: return convert(str, *static_cast<long double*>(value));
+		case TYPE_STRING: static_cast<std::string*>(value)->assign(str.data(), str.size()); return true;
+		case TYPE_VEC2F: return convert(str, *static_cast<Vec2*>(value));
+		case TYPE_VEC2I: return convert(str, *static_cast<Vec2i*>(value));
+		case TYPE_VEC2U: return convert(str, *static_cast<Vec2u*>(value));
+		case TYPE_VEC3F: return convert(str, *static_cast<Vec3*>(value));
+		case TYPE_VEC3I: return convert(str, *static_cast<Vec3i*>(value));
+		case TYPE_VEC3U: return convert(str, *static_cast<Vec3u*>(value));
+		case TYPE_VEC4F: return convert(str, *static_cast<Vec4*>(value));
+		case TYPE_VEC4I: return convert(str, *static_cast<Vec4i*>(value));
+		case TYPE_VEC4U: return convert(str, *static_cast<Vec4u*>(value));
+	}
+
+	return false;
+}
+
+
+const bool CFGParser::convert(std::string_view str, bool& value)
+{
+	if (str == "true" || str == "on" || str == "yes" || str == "1") //Of course, you can add you own values...
+	{
+		value = true;
+		return true;
+	}
+	else if (str == "false" || str == "off" || str == "no" || str == "0")
+	{
+		value = false;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+
+const bool CFGParser::convert(std::string_view str, char& value)
+{
+	if (str.empty()) return false;
+
+	value = str[0];
+	return true;
+}
+
+
+const bool CFGParser::convert(std::string_view str, unsigned char& value)
+{
+	if (str.empty()) return false;
+
+	value = static_cast<unsigned char>(str[0]);
+	return true;
+}
+
+
+const bool CFGParser::convert(std::string_view str, short& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, unsigned short& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, int& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, unsigned int& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, long& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, unsigned long& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, long long& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, unsigned long long& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, float& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, double& value) { return convert_number(str, value); }
+const bool CFGParser::convert(std::string_view str, long double& value) { return convert_number(str, value); }
+
+
+const bool CFGParser::convert(std::string_view str, Vec2& value) { return convert_components(str, &value.x, 2U); }
+const bool CFGParser::convert(std::string_view str, Vec2i& value) { return convert_components(str, &value.x, 2U); }
+const bool CFGParser::convert(std::string_view str, Vec2u& value) { return convert_components(str, &value.x, 2U); }
+const bool CFGParser::convert(std::string_view str, Vec3& value) { return convert_components(str, &value.x, 3U); }
+const bool CFGParser::convert(std::string_view str, Vec3i& value) { return convert_components(str, &value.x, 3U); }
+const bool CFGParser::convert(std::string_view str, Vec3u& value) { return convert_components(str, &value.x, 3U); }
+const bool CFGParser::convert(std::string_view str, Vec4& value) { return convert_components(str, &value.x, 4U); }
+const bool CFGParser::convert(std::string_view str, Vec4i& value) { return convert_components(str, &value.x, 4U); }
+const bool CFGParser::convert(std::string_view str, Vec4u& value) { return convert_components(str, &value.x, 4U); }
+
+
+const std::string& CFGParser::value_of(const value_data& data, const std::string&) const
+{
+	// References were expanded by the change that made them, reading never writes.
+	return (data.state == VALUE_PLAIN || !data.cache) ? data.value : data.cache->expanded;
+}
+
+
+void CFGParser::resolve(const value_data& data, const std::string& section)
+{
+	data.state = VALUE_RESOLVING;
+	if (!data.cache) data.cache.reset(new value_cache());
+	data.cache->parsed = nullptr;
+
+	std::string expanded;
+	bool broken = false;
+	const std::string& str = data.value;
+
+	for (std::size_t i = 0U; i < str.size(); ++i)
+	{
+		if (str[i] != '$' || i + 1U >= str.size())
+		{
+			expanded += str[i];
+		}
+		else if (str[i + 1U] == '$')
+		{
+			expanded += '$';
+			i++;
+		}
+		else if (str[i + 1U] != '{')
+		{
+			expanded += '$';
+		}
+		else
+		{
+			const std::size_t end = str.find('}', i + 2U);
+			if (end == std::string::npos)
+			{
+				this->report(data, "Unterminated reference in \"" + str + "\"!");
+				expanded.append(str, i, std::string::npos);
+				broken = true;
+				break;
+			}
+
+			const std::string name = str.substr(i + 2U, end - i - 2U);
+			const std::size_t colon = name.find(':');
+			const std::string ref_section = (colon == std::string::npos) ? section : name.substr(0U, colon);
+			const std::string ref_key = (colon == std::string::npos) ? name : name.substr(colon + 1U);
+
+			const value_data* ref = this->find_value(ref_section, ref_key);
+			if (!ref)
+			{
+				this->report(data, "Reference ${" + name + "} points to missing section \"" + ref_section + "\" or key \"" + ref_key + "\"!");
+				expanded.append(str, i, end + 1U - i);
+				broken = true;
+			}
+			else if (ref->state == VALUE_RESOLVING)
+			{
+				this->report(data, "Reference ${" + name + "} is cyclic!");
+				expanded.append(str, i, end + 1U - i);
+				broken = true;
+			}
+			else
+			{
+				if (ref->state == VALUE_UNRESOLVED) this->resolve(*ref, ref_section);
+
+				expanded += this->value_of(*ref, ref_section);
+				if (ref->state == VALUE_BROKEN) broken = true;
+			}
+
+			i = end;
+		}
+	}
+
+	data.cache->expanded.swap(expanded);
+	data.state = broken ? VALUE_BROKEN : VALUE_RESOLVED;
+	data.drop_blob();
+}
+
+
+void CFGParser::prepare_values()
+{
+	this->expand_references();
+	if (_schema) this->parse_units(*_schema);
+}
+
+
+void CFGParser::parse_units(const CFGSchema& schema)
+{
+	// Shared sections are read by the parser copies, they were parsed before they were shared.
+	for (section_map* sections : { &_buffer, &_overlay })
+	{
+		if (sections == &_buffer && _frozen) continue;
+
+		for (section_map::value_type& sec : *sections)
+		{
+			if (sec.second.use_count() > 1) continue;
+
+			const std::size_t section = schema.find_section(sec.first);
+			if (section == CFGSchema::npos) continue;
+
+			for (const value_map::value_type& val : sec.second->values) this->parse_units(schema, section, sec.first, val.first, val.second);
+		}
+	}
+}
+
+
+void CFGParser::parse_units(const CFGSchema& schema, const std::size_t section, const std::string& name, const std::string& key, const value_data& data)
+{
+	if (section == CFGSchema::npos || (data.cache && data.cache->parsed)) return;
+
+	const std::size_t rule = schema.find_key(section, key);
+	if (rule == CFGSchema::npos) return;
+
+	switch (schema._keys[rule].type)
+	{
+		case CFGSchema::TYPE_SIZE: this->store_unit<unit_size>(data, name); break;
+		case CFGSchema::TYPE_DURATION: this->store_unit<unit_duration>(data, name); break;
+		case CFGSchema::TYPE_PERCENT: this->store_unit<unit_percent>(data, name); break;
+		default: break;
+	}
+}
+
+
+void CFGParser::expand_references()
+{
+	// All values are expanded after a load, the sections aren't shared yet and can be reset in place.
+	// Values of a frozen parser are shared with the copies of its table and stay as they were frozen.
+	std::vector<std::pair<const std::string*, const value_data*> > pending;
+	_dependents.reset();
+
+	for (section_map* sections : { &_buffer, &_overlay })
+	{
+		if (sections == &_buffer && _frozen) continue;
+
+		for (section_map::value_type& sec : *sections)
+		{
+			if (!sec.second->references) continue;
+
+			for (value_map::value_type& val : sec.second->values)
+			{
+				if (val.second.state == VALUE_PLAIN) continue;
+
+				val.second.state = VALUE_UNRESOLVED;
+				pending.emplace_back(&sec.first, &val.second);
+				this->record_references(val.second, sec.first, val.first, false);
+			}
+		}
+	}
+
+	for (const std::pair<const std::string*, const value_data*>& value : pending)
+	{
+		if (value.second->state == VALUE_UNRESOLVED) this->resolve(*value.second, *value.first);
+	}
+}
+
+
+void CFGParser::record_references(const value_data& data, const std::string& section, const std::string& key, const bool unique)
+{
+	const std::string& str = data.value;
+	const std::string dependent = section + '\0' + key;
+
+	for (std::size_t i = 0U; i + 1U < str.size(); ++i)
+	{
+		if (str[i] != '$') continue;
+		if (str[i + 1U] == '$')
+		{
+			i++;
+			continue;
+		}
+		if (str[i + 1U] != '{') continue;
+
+		const std::size_t end = str.find('}', i + 2U);
+		if (end == std::string::npos) return;
+
+		// Missing keys are recorded too, the reference is expanded again when they are set.
+		const std::string name = str.substr(i + 2U, end - i - 2U);
+		const std::size_t colon = name.find(':');
+		const std::string target = ((colon == std::string::npos) ? section : this->fold_name(name.substr(0U, colon))) + '\0' +
+			this->fold_name((colon == std::string::npos) ? name : name.substr(colon + 1U));
+
+		if (!_dependents) _dependents = std::make_shared<dependency_map>();
+		else if (_dependents.use_count() > 1) _dependents = std::make_shared<dependency_map>(*_dependents);
+
+		std::vector<std::string>& dependents = (*_dependents)[target];
+		if (!unique || std::find(dependents.begin(), dependents.end(), dependent) == dependents.end()) dependents.push_back(dependent);
+
+		i = end;
+	}
+}
+
+
+void CFGParser::update_values(const std::vector<std::string>& names)
+{
+	// Only the changed values and the values, which reference them directly or through others, are expanded again.
+	// Their sections are copied first, if they are shared. The names of the old references stay recorded,
+	// expanding such a value once more gives the same result.
+	std::vector<std::pair<const std::string*, const value_map::value_type*> > pending;
+	std::unordered_set<std::string> seen(names.begin(), names.end());
+	std::vector<std::string> queue(names);
+
+	for (std::size_t i = 0U; i < queue.size(); ++i)
+	{
+		const std::string name = queue[i];
+		const std::size_t split = name.find('\0');
+		const std::string section = name.substr(0U, split);
+		const std::string key = name.substr(split + 1U);
+		const bool changed = i < names.size();
+
+		for (section_map* sections : { &_buffer, &_overlay })
+		{
+			if (sections == &_buffer && _frozen) continue;
+
+			section_map::iterator sit = sections->find(section);
+			if (sit == sections->end()) continue;
+
+			value_map::iterator vit = (*sit).second->values.find(key);
+			if (vit == (*sit).second->values.end()) continue;
+
+			// Unchanged plain values of shared sections were parsed before they were shared.
+			if ((*vit).second.state == VALUE_PLAIN && (!changed || (*sit).second.use_count() > 1)) continue;
+
+			if ((*sit).second.use_count() > 1) vit = this->writable_section(sit).values.find(key);
+			if (changed && (*vit).second.state == VALUE_UNRESOLVED) this->record_references((*vit).second, (*sit).first, (*vit).first, true);
+			if ((*vit).second.state != VALUE_PLAIN) (*vit).second.state = VALUE_UNRESOLVED;
+
+			pending.emplace_back(&(*sit).first, &(*vit));
+		}
+
+		if (!_dependents) continue;
+
+		const dependency_map::const_iterator it = _dependents->find(name);
+		if (it == _dependents->end()) continue;
+
+		for (const std::string& dependent : (*it).second)
+		{
+			if (seen.insert(dependent).second) queue.push_back(dependent);
+		}
+	}
+
+	for (const std::pair<const std::string*, const value_map::value_type*>& value : pending)
+	{
+		if (value.second->second.state == VALUE_UNRESOLVED) this->resolve(value.second->second, *value.first);
+	}
+
+	if (!_schema) return;
+
+	for (const std::pair<const std::string*, const value_map::value_type*>& value : pending)
+	{
+		this->parse_units(*_schema, _schema->find_section(*value.first), *value.first, value.second->first, value.second->second);
+	}
+}
+
+
+const std::string CFGParser::set_override(const std::string& section, const std::string& key, const std::string& value)
+{
+	const bool fold = (_options & CASE_INSENSITIVE) != 0U;
+	const char* source = "overrides";
+
+	std::vector<std::string>::iterator it = std::find(_files.begin(), _files.end(), source);
+	if (it == _files.end()) it = _files.insert(_files.end(), source);
+
+	value_data data;
+	data.value = value;
+	data.file = static_cast<std::uint32_t>(it - _files.begin());
+	data.state = (value.find('$') != std::string::npos) ? VALUE_UNRESOLVED : VALUE_PLAIN;
+
+	section_map::iterator sit = _overlay.find(section);
+	if (sit == _overlay.end()) sit = _overlay.emplace(this->fold_name(section), std::make_shared<section_data>(fold)).first;
+
+	value_map& values = (*sit).second->values;
+	if (data.state != VALUE_PLAIN) (*sit).second->references = true;
+	value_map::iterator itr = values.find(key);
+	if (itr != values.end()) (*itr).second = data;
+	else itr = values.emplace(this->fold_name(key), data).first;
+
+	(*itr).second.state = data.state;
+	return (*sit).first + '\0' + (*itr).first;
+}
+
+
+void CFGParser::report(const value_data& data, const std::string& message)
+{
+	this->report(data.file, data.line, message);
+}
+
+
+void CFGParser::report(const std::uint32_t file, const std::size_t line, const std::string& message)
+{
+	error_data error;
+	error.file = (file < _files.size()) ? _files[file] : std::string();
+	error.line = line;
+	error.message = message;
+	_errors.push_back(error);
+
+	std::cout << error.message << " File \"" << error.file << "\", line " << error.line << "\n}" << std::endl;
+}
+
+
+const std::uint64_t CFGParser::hash_name(const char* str, const std::size_t size, const std::uint64_t seed, const bool fold)
+{
+	std::uint64_t hash = seed ^ (size * 0x9E3779B97F4A7C15ULL);
+	std::size_t i = 0U;
+
+	for (; i + 8U <= size; i += 8U)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, str + i, 8U);
+		if (fold) word = fold_word(word);
+		hash = (hash ^ hash_mix(word)) * 0x9E3779B97F4A7C15ULL;
+	}
+
+	std::uint64_t tail = 0U;
+	for (; i < size; ++i) tail = (tail << 8U) | static_cast<unsigned char>(fold ? fold_char(str[i]) : str[i]);
+
+	return hash_mix(hash ^ hash_mix(tail));
+}
+
+
+const bool CFGParser::place_hashes(const std::vector<std::uint64_t>& hashes, std::vector<std::uint64_t>& displacements, std::vector<std::size_t>& positions)
+{
+	// Hash and displace: keys are spread over buckets of ~2 keys, then the biggest
+	// buckets are placed first, each with the first displacement which moves all its
+	// keys to free slots.
+	const std::size_t count = hashes.size();
+	const std::size_t bucket_num = count / 2U + 1U;
+
+	std::vector<std::vector<std::size_t> > buckets(bucket_num);
+	for (std::size_t i = 0U; i < count; ++i) buckets[(hashes[i] >> 32U) % bucket_num].push_back(i);
+
+	std::vector<std::size_t> bucket_order(bucket_num);
+	for (std::size_t i = 0U; i < bucket_num; ++i) bucket_order[i] = i;
+	std::stable_sort(bucket_order.begin(), bucket_order.end(), [&buckets](const std::size_t a, const std::size_t b)
+	{
+		return buckets[a].size() > buckets[b].size();
+	});
+
+	displacements.assign(bucket_num, 0U);
+	positions.resize(count);
+	std::vector<bool> used(count, false);
+
+	for (const std::size_t b : bucket_order)
+	{
+		const std::vector<std::size_t>& bucket = buckets[b];
+		if (bucket.empty()) break;
+
+		bool placed = false;
+		for (std::uint64_t d = 0U; d < (1U << 20U) && !placed; ++d)
+		{
+			const std::uint64_t displacement = (d == 0U) ? 0U : hash_mix(d);
+			placed = true;
+
+			for (std::size_t i = 0U; i < bucket.size() && placed; ++i)
+			{
+				positions[bucket[i]] = frozen_position(hashes[bucket[i]], displacement, count);
+				if (used[positions[bucket[i]]]) placed = false;
+
+				for (std::size_t j = 0U; j < i && placed; ++j)
+				{
+					if (positions[bucket[j]] == positions[bucket[i]]) placed = false;
+				}
+			}
+
+			if (placed) displacements[b] = displacement;
+		}
+
+		if (!placed) return false;
+
+		for (const std::size_t i : bucket) used[positions[i]] = true;
+	}
+
+	return true;
+}
+
+
+const CFGParser::value_data* CFGParser::find_value(const std::string& section, const std::string& key) const
+{
+	if (!_overlay.empty())
+	{
+		const section_map::const_iterator it = _overlay.find(section);
+		if (it != _overlay.end())
+		{
+			const value_map::const_iterator itr = (*it).second->values.find(key);
+			if (itr != (*it).second->values.end()) return &(*itr).second;
+		}
+	}
+
+	if (_frozen) return this->find_frozen(section, key);
+
+	const section_map::const_iterator it = _buffer.find(section);
+	if (it == _buffer.end()) return nullptr;
+
+	const value_map::const_iterator itr = (*it).second->values.find(key);
+	return (itr != (*it).second->values.end()) ? &(*itr).second : nullptr;
+}
+
+
+const CFGParser::value_data* CFGParser::find_frozen(const std::string& section, const std::string& key) const
+{
+	const frozen_table& table = *_frozen;
+	if (table.slots.empty()) return nullptr;
+
+	const bool fold = (_options & CASE_INSENSITIVE) != 0U;
+	return this->find_frozen(hash_name(key.data(), key.size(), hash_name(section.data(), section.size(), table.seed, fold), fold));
+}
+
+
+const CFGParser::value_data* CFGParser::find_frozen(const std::uint64_t hash) const
+{
+	const frozen_table& table = *_frozen;
+	if (table.slots.empty()) return nullptr;
+
+	const std::uint64_t displacement = table.displacement[(hash >> 32U) % table.displacement.size()];
+	const frozen_slot& slot = table.slots[frozen_position(hash, displacement, table.slots.size())];
+
+	return (slot.fingerprint == hash) ? slot.data : nullptr;
+}
+
+
+void CFGParser::begin_load()
+{
+	_buffer.clear();
+	_order.clear();
+	_section_index.clear();
+	_key_index.clear();
+	_frozen.reset();
+	_files.clear();
+	_errors.clear();
+	_includes.reset();
+	_generation++;
+
+	_symbols.clear();
+	_symbols_hash = 0U;
+	for (const std::pair<const std::string, std::string>& symbol : _defines) this->set_symbol(symbol.first, symbol.second);
+}
+
+
+const bool CFGParser::end_load()
 {
-	if (this->isSectionKeyExist(section, key))
+	// Parsed files are shared between includes of one load only.
+	_file_cache.clear();
+	_includes.reset();
+	_reader.clear();
+	_symbols.clear();
+
+	// Overrides survive reloads, their source name has to be registered again.
+	if (!_overlay.empty())
 	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
+		const std::uint32_t source = static_cast<std::uint32_t>(_files.size());
+		_files.push_back("overrides");
 
-		for (std::size_t i = 0U; i < str.size(); ++i)
+		for (section_map::value_type& sec : _overlay)
 		{
-			const char& ch = str[i];
-			switch (ch)
-			{
-			case ',':
-				vec.push_back(svalue);
-				svalue.clear();
-				break;
-
-			default:
-				svalue += ch;
-				break;
-			}
+			for (value_map::value_type& val : sec.second->values) val.second.file = source;
 		}
+	}
 
-		const std::size_t vsize = vec.size();
+	this->prepare_values();
 
-		if (vsize < 2U)
-		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 2 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else if (vsize > 2U)
+	if (_schema) this->validate(*_schema);
+
+	return !_buffer.empty() || !_files.empty();
+}
+
+
+void CFGParser::process_file(const std::string& cfg_file)
+{
+	const std::string path = _includes.resolve(cfg_file, std::string(), std::string());
+	if (path.empty())
+	{
+		std::cout << "File \"" << cfg_file << "\" not be opened!" << "\n" << std::endl;
+		return;
+	}
+
+	std::string error;
+	if (_includes.enter(path, error))
+	{
+		const std::shared_ptr<const file_data> file = this->load_file(path);
+		_includes.leave();
+
+		if (file) this->apply_file(*file);
+	}
+}
+
+
+const std::shared_ptr<const CFGParser::file_data> CFGParser::load_file(const std::string& path)
+{
+	const std::unordered_map<std::string, std::shared_ptr<const file_data> >::const_iterator it = _file_cache.find(path);
+	if (it != _file_cache.end() && (!(*it).second->conditional || (*it).second->symbols == _symbols_hash))
+	{
+		// Same symbols give the same records, only the symbols they define have to be repeated.
+		this->replay_symbols(*(*it).second);
+		return (*it).second;
+	}
+
+	std::string text;
+	if (!_reader.take(path, text))
+	{
+		std::cout << "File \"" << path << "\" not be opened!" << "\n" << std::endl;
+		return nullptr;
+	}
+
+	// Includes are read while this file is tokenized.
+	this->prefetch_includes(text, path);
+
+	std::shared_ptr<file_data> file = std::make_shared<file_data>();
+	file->path = path;
+	file->conditional = false;
+	file->symbols = _symbols_hash;
+
+	if (it != _file_cache.end())
+	{
+		file->index = (*it).second->index;
+	}
+	else
+	{
+		file->index = static_cast<std::uint32_t>(_files.size());
+		_files.push_back(path);
+	}
+
+	if ((_options & VALIDATE_UTF8) != 0U)
+	{
+		const std::size_t invalid = validate_utf8(text.data(), text.size());
+		if (invalid != text.size())
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 2 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			const std::size_t line = static_cast<std::size_t>(std::count(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(invalid), '\n')) + 1U;
+			this->report(file->index, line, "Invalid UTF-8 at byte " + std::to_string(invalid) + ", file is skipped!");
+			return nullptr;
 		}
-		else
+	}
+
+	this->parse_buffer(text.data(), text.size(), *file);
+
+	_file_cache[path] = file;
+	return file;
+}
+
+
+void CFGParser::apply_file(const file_data& file)
+{
+	for (const record_data& record : file.records)
+	{
+		switch (record.type)
 		{
-			return Vec2u(static_cast<unsigned int>(std::stoul(vec[0])), static_cast<unsigned int>(std::stoul(vec[1])));
+			case RECORD_VALUE:
+			{
+				value_data data;
+				data.value = record.value;
+				data.line = record.line;
+				data.file = file.index;
+				this->insert_value(record.section, record.name, data);
+			}
+			break;
+
+			case RECORD_INHERIT:
+				if (this->isSectionExist(record.name))
+				{
+					// Copy the keys first: inheriting from itself would change the order index while walking it.
+					const std::vector<const value_map::value_type*> inherited = _buffer.at(record.name)->order;
+					for (const value_map::value_type* itr : inherited)
+					{
+						value_data data;
+						data.value = (*itr).second.value;
+						data.line = record.line;
+						data.file = file.index;
+						this->insert_value(record.section, (*itr).first, data);
+					}
+				}
+				else
+				{
+					std::cout << "Inherited section \"" << record.name << "\" not exist!" << "\n}" << std::endl;
+				}
+			break;
+
+			case RECORD_INCLUDE:
+				if (record.include) this->apply_file(*record.include);
+			break;
+
+			case RECORD_DEFINE:
+			case RECORD_UNDEF:
+			break;
 		}
 	}
-	else
+}
+
+
+void CFGParser::parse_buffer(const char* data, const std::size_t size, file_data& file)
+{
+	parse_state state;
+	state.ptype = KEY;
+	state.line = 0U;
+	state.messages = nullptr;
+
+	// UTF-8 byte order mark.
+	const std::size_t bom = (size >= 3U && std::memcmp(data, "\xEF\xBB\xBF", 3U) == 0) ? 3U : 0U;
+	if ((_options & PARALLEL_PARSE) != 0U && this->parse_parallel(data + bom, data + size, file)) return;
+
+	this->parse_lines(data + bom, data + size, state, file);
+
+	if (!state.conditions.empty()) this->report(file.index, state.line, "Unterminated #if block!");
+}
+
+
+void CFGParser::parse_lines(const char* pos, const char* end, parse_state& state, file_data& file)
+{
+	while (pos < end)
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
+		if (!state.conditions.empty() && state.conditions.back() != CONDITION_ACTIVE)
+		{
+			pos = skip_block(pos, end, state.line);
+			if (pos == end) break;
+		}
+
+		const char* nl = static_cast<const char*>(std::memchr(pos, '\n', static_cast<std::size_t>(end - pos)));
+		const char* line_end = nl ? nl : end;
+		if (line_end > pos && line_end[-1] == '\r') line_end--;
+
+		this->parse_line(std::string_view(pos, static_cast<std::size_t>(line_end - pos)), state, file);
+
+		pos = nl ? nl + 1 : end;
 	}
 }
 
 
-const Vec3 CFGParser::getVec3f(const std::string& section, const std::string& key, const Vec3& default_value) const
+const bool CFGParser::parse_parallel(const char* pos, const char* end, file_data& file)
 {
-	if (this->isSectionKeyExist(section, key))
+	static const std::size_t min_part = 1U << 20U;
+
+	const std::size_t size = static_cast<std::size_t>(end - pos);
+	const std::size_t threads = std::min(static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U)), size / min_part);
+	if (threads < 2U) return false;
+
+	// Parts start at a line with '[', so each one begins with a section header. Strings end with their line and never cross a split.
+	std::vector<const char*> bounds(1U, pos);
+	for (std::size_t i = 1U; i < threads; ++i)
 	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
+		const char* scan = std::max(pos + size / threads * i, bounds.back());
+		const char* start = end;
 
-		for (std::size_t i = 0U; i < str.size(); ++i)
+		while (scan < end)
 		{
-			const char& ch = str[i];
-			switch (ch)
-			{
-			case ',':
-				vec.push_back(svalue);
-				svalue.clear();
-				break;
+			const char* nl = static_cast<const char*>(std::memchr(scan, '\n', static_cast<std::size_t>(end - scan)));
+			if (!nl || nl + 1 == end) break;
 
-			default:
-				svalue += ch;
+			if (nl[1] == '[')
+			{
+				start = nl + 1;
 				break;
 			}
+
+			scan = nl + 1;
 		}
 
-		vec.push_back(svalue);
-		svalue.clear();
+		if (start == end) break;
+		bounds.push_back(start);
+	}
 
-		const std::size_t vsize = vec.size();
+	bounds.push_back(end);
+	const std::size_t parts = bounds.size() - 1U;
+	if (parts < 2U) return false;
 
-		if (vsize < 3u)
-		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 3 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else if (vsize > 3u)
+	// Directives affect the rest of the file and may include other files, such files are parsed serially.
+	// The search for them counts the lines of each part, which gives the first line number of the next parts.
+	std::vector<std::future<std::size_t> > counts;
+	for (std::size_t i = 0U; i < parts; ++i)
+	{
+		counts.push_back(std::async(std::launch::async, [&bounds, i]()
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 3 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else
+			std::size_t lines = 0U;
+			return (skip_block(bounds[i], bounds[i + 1U], lines) == bounds[i + 1U]) ? lines : std::string::npos;
+		}));
+	}
+
+	std::vector<std::size_t> first_lines(parts, 0U);
+	bool directives = false;
+	for (std::size_t i = 0U; i < parts; ++i)
+	{
+		const std::size_t lines = counts[i].get();
+		if (lines == std::string::npos) directives = true;
+		else if (i + 1U < parts) first_lines[i + 1U] = first_lines[i] + lines;
+	}
+
+	if (directives) return false;
+
+	// Parts print nothing on their own, their messages follow the file order after the join.
+	std::vector<parse_state> states(parts);
+	std::vector<std::vector<record_data> > records(parts);
+	std::vector<std::string> messages(parts);
+	std::vector<std::future<void> > workers;
+
+	for (std::size_t i = 0U; i < parts; ++i)
+	{
+		workers.push_back(std::async(std::launch::async, [this, &bounds, &states, &records, &messages, &first_lines, &file, i]()
 		{
-			return Vec3(std::stof(vec[0]), std::stof(vec[1]), std::stof(vec[2]));
-		}
+			file_data part;
+			part.index = file.index;
+			states[i].ptype = KEY;
+			states[i].line = first_lines[i];
+			states[i].messages = &messages[i];
+
+			this->parse_lines(bounds[i], bounds[i + 1U], states[i], part);
+			records[i].swap(part.records);
+		}));
 	}
-	else
+
+	for (std::future<void>& worker : workers) worker.get();
+
+	// A part starts with a clean state, unless the line before it broke off a key. That part goes again with the state it would have had.
+	for (std::size_t i = 1U; i < parts; ++i)
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
+		const parse_state& before = states[i - 1U];
+		if (before.key.empty() && before.value.empty() && before.inherit_name.empty() && before.preprocess.empty()) continue;
+
+		file_data part;
+		part.index = file.index;
+		states[i] = before;
+		states[i].messages = &messages[i];
+		messages[i].clear();
+
+		this->parse_lines(bounds[i], bounds[i + 1U], states[i], part);
+		records[i].swap(part.records);
 	}
+
+	for (const std::string& part : messages) std::cout << part;
+	std::cout.flush();
+
+	std::size_t total = 0U;
+	for (const std::vector<record_data>& part : records) total += part.size();
+
+	// Records keep the file order, so the last definition still wins and inheritance sees the same keys.
+	file.records.reserve(file.records.size() + total);
+	for (std::vector<record_data>& part : records) std::move(part.begin(), part.end(), std::back_inserter(file.records));
+
+	return true;
 }
 
 
-const Vec3i CFGParser::getVec3i(const std::string& section, const std::string& key, const Vec3i& default_value) const
+const bool CFGParser::decode_base64(std::string_view str, std::vector<unsigned char>& blob)
 {
-	if (this->isSectionKeyExist(section, key))
+	while (!str.empty() && str.back() == '=' && str.size() % 4U != 1U) str.remove_suffix(1U);
+	if (str.size() % 4U == 1U) return false;
+
+	// 16 bytes of slack: a vector step stores 16 bytes for 12 decoded.
+	blob.resize(str.size() / 4U * 3U + 2U + 16U);
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(str.data());
+	unsigned char* out = blob.data();
+	std::size_t i = 0U;
+
+#ifdef CFG_SSSE3
+	// Characters are classified by their nibbles with two table lookups and shifted to 6-bit values by a third.
+	const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	for (; i + 16U <= str.size(); i += 16U)
 	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
+		const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		const __m128i hi = _mm_and_si128(_mm_srli_epi32(chars, 4), nibble);
+		const __m128i lo = _mm_and_si128(chars, nibble);
 
-		for (std::size_t i = 0U; i < str.size(); ++i)
-		{
-			const char& ch = str[i];
-			switch (ch)
-			{
-			case ',':
-				vec.push_back(svalue);
-				svalue.clear();
-				break;
+		const __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo), _mm_shuffle_epi8(lut_hi, hi));
+		if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) != 0) break; // the rest goes the scalar way
 
-			default:
-				svalue += ch;
-				break;
-			}
-		}
+		const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('/')), hi));
+		const __m128i values = _mm_add_epi8(chars, roll);
 
-		vec.push_back(svalue);
-		svalue.clear();
+		const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(merged, pack));
+		out += 12;
+	}
+#endif
 
-		const std::size_t vsize = vec.size();
+	std::uint32_t bits = 0U;
+	std::size_t count = 0U;
 
-		if (vsize < 3u)
-		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 3 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else if (vsize > 3u)
+	for (; i < str.size(); ++i)
+	{
+		const unsigned char chr = in[i];
+		int value;
+
+		if (chr >= 'A' && chr <= 'Z') value = chr - 'A';
+		else if (chr >= 'a' && chr <= 'z') value = chr - 'a' + 26;
+		else if (chr >= '0' && chr <= '9') value = chr - '0' + 52;
+		else if (chr == '+' || chr == '-') value = 62;
+		else if (chr == '/' || chr == '_') value = 63;
+		else
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 3 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			return false;
 		}
-		else
+
+		bits = (bits << 6U) | static_cast<std::uint32_t>(value);
+		if (++count == 4U)
 		{
-			return Vec3i(std::stoi(vec[0]), std::stoi(vec[1]), std::stoi(vec[2]));
+			*out++ = static_cast<unsigned char>(bits >> 16U);
+			*out++ = static_cast<unsigned char>(bits >> 8U);
+			*out++ = static_cast<unsigned char>(bits);
+			bits = 0U;
+			count = 0U;
 		}
 	}
-	else
+
+	if (count == 2U)
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
+		*out++ = static_cast<unsigned char>(bits >> 4U);
 	}
+	else if (count == 3U)
+	{
+		*out++ = static_cast<unsigned char>(bits >> 10U);
+		*out++ = static_cast<unsigned char>(bits >> 2U);
+	}
+
+	blob.resize(static_cast<std::size_t>(out - blob.data()));
+	return true;
 }
 
 
-const Vec3u CFGParser::getVec3u(const std::string& section, const std::string& key, const Vec3u& default_value) const
+const bool CFGParser::decode_hex(std::string_view str, std::vector<unsigned char>& blob)
 {
-	if (this->isSectionKeyExist(section, key))
+	if (str.size() % 2U != 0U) return false;
+
+	blob.resize(str.size() / 2U);
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(str.data());
+	unsigned char* out = blob.data();
+	std::size_t i = 0U;
+
+#ifdef CFG_SSE2
+	// Digits and lowercased letters are turned to nibbles, pairs of them are joined in 16-bit lanes.
+	for (; i + 32U <= str.size(); i += 32U)
 	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
+		__m128i nibbles[2];
+		bool valid = true;
 
-		for (std::size_t i = 0U; i < str.size(); ++i)
+		for (std::size_t half = 0U; half < 2U; ++half)
 		{
-			const char& ch = str[i];
-			switch (ch)
-			{
-			case ',':
-				vec.push_back(svalue);
-				svalue.clear();
-				break;
+			const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + half * 16U));
+			const __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+			const __m128i letters = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a' - 10));
 
-			default:
-				svalue += ch;
+			// Unsigned range checks: digits 0..9, letters 10..15.
+			const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+			const __m128i letter_offset = _mm_sub_epi8(letters, _mm_set1_epi8(10));
+			const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter_offset, _mm_set1_epi8(5)), letter_offset);
+
+			if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF)
+			{
+				valid = false;
 				break;
 			}
+
+			nibbles[half] = _mm_or_si128(_mm_and_si128(is_digit, digits), _mm_andnot_si128(is_digit, letters));
 		}
 
-		vec.push_back(svalue);
-		svalue.clear();
+		if (!valid) break;
 
-		const std::size_t vsize = vec.size();
+		__m128i bytes[2];
+		for (std::size_t half = 0U; half < 2U; ++half)
+		{
+			const __m128i high = _mm_and_si128(_mm_slli_epi16(nibbles[half], 4), _mm_set1_epi16(0x00F0));
+			const __m128i low = _mm_srli_epi16(nibbles[half], 8);
+			bytes[half] = _mm_or_si128(high, low);
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(bytes[0], bytes[1]));
+		out += 16;
+	}
+#endif
 
-		if (vsize < 3u)
+	for (; i < str.size(); i += 2U)
+	{
+		int nibble[2];
+		for (std::size_t j = 0U; j < 2U; ++j)
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 3 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			const unsigned char chr = in[i + j];
+			if (chr >= '0' && chr <= '9') nibble[j] = chr - '0';
+			else if (chr >= 'a' && chr <= 'f') nibble[j] = chr - 'a' + 10;
+			else if (chr >= 'A' && chr <= 'F') nibble[j] = chr - 'A' + 10;
+			else
+			{
+				return false;
+			}
 		}
-		else if (vsize > 3u)
+
+		*out++ = static_cast<unsigned char>((nibble[0] << 4) | nibble[1]);
+	}
+
+	return true;
+}
+
+
+const std::size_t CFGParser::validate_utf8(const char* data, const std::size_t size)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+	std::size_t i = 0U;
+
+	while (i < size)
+	{
+#ifdef CFG_SSE2
+		// Configs are mostly ASCII: whole blocks without high bits are skipped.
+		while (i + 16U <= size && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i))) == 0) i += 16U;
+		if (i >= size) break;
+#endif
+		const unsigned char lead = bytes[i];
+		if (lead < 0x80U)
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 3 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			i++;
+			continue;
 		}
+
+		std::size_t length;
+		unsigned char low = 0x80U, high = 0xBFU; // allowed range of the second byte
+
+		if (lead >= 0xC2U && lead <= 0xDFU) length = 2U;
+		else if (lead == 0xE0U) { length = 3U; low = 0xA0U; }
+		else if (lead >= 0xE1U && lead <= 0xECU) length = 3U;
+		else if (lead == 0xEDU) { length = 3U; high = 0x9FU; } // no surrogates
+		else if (lead >= 0xEEU && lead <= 0xEFU) length = 3U;
+		else if (lead == 0xF0U) { length = 4U; low = 0x90U; }
+		else if (lead >= 0xF1U && lead <= 0xF3U) length = 4U;
+		else if (lead == 0xF4U) { length = 4U; high = 0x8FU; } // up to U+10FFFF
 		else
 		{
-			return Vec3u(std::stoul(vec[0]), std::stoul(vec[1]), std::stoul(vec[2]));
+			return i;
+		}
+
+		if (i + length > size || bytes[i + 1U] < low || bytes[i + 1U] > high) return i;
+
+		for (std::size_t j = 2U; j < length; ++j)
+		{
+			if ((bytes[i + j] & 0xC0U) != 0x80U) return i;
+		}
+
+		i += length;
+	}
+
+	return size;
+}
+
+
+void CFGParser::parse_line(std::string_view temp, parse_state& state, file_data& file)
+{
+	state.line++;
+
+	if (temp.empty() || temp[0] == ';') return;
+
+	const std::size_t first = temp.find_first_not_of(" \t");
+	if (first != std::string_view::npos && temp[first] == '#' && this->parse_directive(temp.substr(first), state, file)) return;
+
+	state.ptype = KEY;
+
+	const std::size_t line_length = temp.size();
+
+	for (std::size_t i = 0; i < line_length; ++i)
+	{
+		const char& chr = temp[i];
+		switch (chr)
+		{
+			case '[':
+				if (state.ptype == STRING) state.value += '[';
+				else
+				{
+					state.ptype = SECTION;
+					state.section.clear();
+				}
+			break;
+
+			case ']':
+				if (state.ptype == STRING) state.value += ']';
+			break;
+
+			case '#':
+				if (state.ptype == STRING) state.value += '#';
+				else
+				{
+					state.ptype = PREPROCESSOR;
+					state.preprocess.clear();
+				}
+			break;
+/*
+			case '<':
+				if (state.ptype == PREPROCESSOR)
+				{
+
+					for (std::size_t nm = i; nm < line_length; nm++)
+					{
+						if (temp.at(nm) == '>')
+						{
+							break;
+						}
+						else
+						{
+
+						}
+					}
+
+					i = (line_length - 1U);
+				}
+			break;
+
+			case '>':
+
+			break;
+*/
+			case ':':
+				if (state.ptype == SECTION)
+				{
+					state.ptype = INHERIT;//Если у нас все еще секция, то можно наследовать конфиги
+#ifdef DEBUG
+					std::cout << "Inheriting from \"";// << std::std::endl;
+#endif
+				}
+				else if (state.ptype == STRING || state.ptype == VALUE)
+				{
+					state.value += ':';
+				}
+			break;
+
+			case '=':
+				if (state.ptype == STRING || state.ptype == VALUE) state.value += '=';
+				else state.ptype = VALUE;
+			break;
+
+			case ';':
+				if (state.ptype == STRING) state.value += ';';
+				else i = (line_length - 1U);
+			break;
+
+			case '\"':
+				if (state.ptype == VALUE)
+				{
+					state.ptype = STRING;
+				}
+				else if(state.ptype == STRING)
+				{
+					state.ptype = KEY;
+				}
+			break;
+
+			case ' ':
+				if (state.ptype == STRING) state.value += ' ';
+			break;
+
+			case '\t':
+				if (state.ptype == STRING) state.value += '\t';
+			break;
+
+			case '\\':
+				if (state.ptype == STRING && (temp.size() > (i + 1)))
+				{				
+					const char& next_char = temp[i + 1];
+
+					switch (next_char)
+					{
+						case 'n':
+							state.value += '\n';
+						break;
+
+						case 't':
+							state.value += '\t';
+						break;
+
+						case '\"':
+							state.value += '\"';
+						break;
+
+						case '\'':
+							state.value += '\'';
+						break;
+
+						case '\\':
+							state.value += '\\';
+						break;
+
+						default:
+							parse_message(state, "Unknown escape character! Line: " + std::to_string(state.line));
+						break;
+					}
+
+					i++;
+				}
+			break;
+
+			default:
+			{
+				switch (state.ptype)
+				{
+					case SECTION:
+						state.section += chr;
+					break;
+
+					case KEY:
+						state.key += chr;
+					break;
+
+					case VALUE:
+						state.value += chr;
+					break;
+
+					case STRING:
+						state.value += chr;
+					break;
+
+					case PREPROCESSOR:
+						state.preprocess += chr;
+					break;
+
+					case INHERIT:
+						state.inherit_name += chr;
+					break;
+				}
+			}
+			break;
 		}
 	}
-	else
+
+	//////////////////////////////////////////////////////
+	//Errors check
+	//////////////////////////////////////////////////////
+	
+	const bool section_empty = state.section.empty();
+	const bool inherit_empty = state.inherit_name.empty();
+	const bool key_empty = state.key.empty();
+	const bool value_empty = state.value.empty();
+	const bool preproces_empty = state.preprocess.empty();
+
+	if (section_empty && state.ptype == SECTION) parse_message(state, "Syntax error! Section name is empty at line " + std::to_string(state.line) + "!");
+	if (inherit_empty && state.ptype == INHERIT) parse_message(state, "Syntax error! Inherit name is empty at line " + std::to_string(state.line) + "!");
+	if (key_empty && state.ptype == KEY && state.ptype != SECTION) parse_message(state, "Syntax error! Key string is empty at line " + std::to_string(state.line) + "!");
+	if (value_empty && state.ptype == KEY) parse_message(state, "Syntax error! Line doesn't have a \'=\' symbol at line " + std::to_string(state.line) + "!");
+	if (value_empty && state.ptype == VALUE) parse_message(state, "Can't find value at line " + std::to_string(state.line) + "!");
+	if (preproces_empty && state.ptype == PREPROCESSOR) parse_message(state, "Syntax error! Preprocessor command is empty at line " + std::to_string(state.line) + "!");
+	//////////////////////////////////////////////////////
+
+	if (state.ptype == INHERIT && !inherit_empty)
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
+#ifdef DEBUG
+		std::cout << state.inherit_name << "\" to section \"" << state.section << "\"..." << std::endl;
+#endif
+		record_data record;
+		record.type = RECORD_INHERIT;
+		record.section = state.section;
+		record.name = state.inherit_name;
+		record.line = state.line;
+		file.records.push_back(record);
+
+		state.inherit_name.clear();
+		state.ptype = KEY;
+	}
+
+	if (!section_empty && state.ptype != SECTION && !key_empty)
+	{
+		record_data record;
+		record.type = RECORD_VALUE;
+		record.section = state.section;
+		record.name = state.key;
+		record.value = state.value;
+		record.line = state.line;
+		file.records.push_back(record); // Errors check?
+
+		state.key.clear();
+		state.value.clear();
 	}
 }
 
 
-const Vec4 CFGParser::getVec4f(const std::string& section, const std::string& key, const Vec4& default_value) const
+void CFGParser::parse_message(const parse_state& state, const std::string& message)
 {
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
+	if (state.messages) *state.messages += message + "\n}\n";
+	else std::cout << message << "\n}" << std::endl;
+}
 
-		for (std::size_t i = 0U; i < str.size(); ++i)
-		{
-			const char& ch = str[i];
-			switch (ch)
-			{
-			case ',':
-				vec.push_back(svalue);
-				svalue.clear();
-				break;
 
-			default:
-				svalue += ch;
-				break;
-			}
-		}
+const bool CFGParser::parse_directive(std::string_view text, parse_state& state, file_data& file)
+{
+	const std::size_t name_end = std::min(text.find_first_of(" \t\r\"<", 1U), text.size());
+	const std::string_view name = text.substr(1U, name_end - 1U);
 
-		vec.push_back(svalue);
-		svalue.clear();
+	std::string_view args = text.substr(name_end);
+	const std::size_t args_begin = args.find_first_not_of(" \t");
+	args = (args_begin != std::string_view::npos) ? args.substr(args_begin, args.find_last_not_of(" \t\r") + 1U - args_begin) : std::string_view();
 
-		const std::size_t vsize = vec.size();
+	const bool active = state.conditions.empty() || state.conditions.back() == CONDITION_ACTIVE;
 
-		if (vsize < 4u)
-		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 4 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
-		}
-		else if (vsize > 4u)
+	if (name == "if" || name == "ifdef" || name == "ifndef")
+	{
+		file.conditional = true;
+
+		if (!active)
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 4 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			state.conditions.push_back(CONDITION_DONE);
 		}
 		else
 		{
-			return Vec4(std::stof(vec[0]), std::stof(vec[1]), std::stof(vec[2]), std::stof(vec[3]));
+			const bool taken = (name == "if") ? this->evaluate(args) : ((name == "ifdef") == (_symbols.find(std::string(args)) != _symbols.end()));
+			state.conditions.push_back(taken ? CONDITION_ACTIVE : CONDITION_SEARCHING);
 		}
 	}
-	else
-	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
-}
-
-
-const Vec4i CFGParser::getVec4i(const std::string& section, const std::string& key, const Vec4i& default_value) const
-{
-	if (this->isSectionKeyExist(section, key))
+	else if (name == "elif" || name == "else")
 	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
-
-		for (std::size_t i = 0U; i < str.size(); ++i)
+		if (state.conditions.empty())
 		{
-			const char& ch = str[i];
-			switch (ch)
-			{
-			case ',':
-				vec.push_back(svalue);
-				svalue.clear();
-				break;
-
-			default:
-				svalue += ch;
-				break;
-			}
+			this->report(file.index, state.line, "#" + std::string(name) + " without #if!");
 		}
-
-		vec.push_back(svalue);
-		svalue.clear();
-
-		const std::size_t vsize = vec.size();
-
-		if (vsize < 4u)
+		else if (state.conditions.back() == CONDITION_ACTIVE)
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 4 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			state.conditions.back() = CONDITION_DONE;
 		}
-		else if (vsize > 4u)
+		else if (state.conditions.back() == CONDITION_SEARCHING && (name == "else" || this->evaluate(args)))
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 4 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			state.conditions.back() = CONDITION_ACTIVE;
 		}
+	}
+	else if (name == "endif")
+	{
+		if (state.conditions.empty()) this->report(file.index, state.line, "#endif without #if!");
 		else
 		{
-			return Vec4i(std::stoi(vec[0]), std::stoi(vec[1]), std::stoi(vec[2]), std::stoi(vec[3]));
+			state.conditions.pop_back();
 		}
 	}
-	else
+	else if (!active)
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
+		// Everything else inside a skipped block is ignored.
 	}
-}
-
-
-const Vec4u CFGParser::getVec4u(const std::string& section, const std::string& key, const Vec4u& default_value) const
-{
-	if (this->isSectionKeyExist(section, key))
+	else if (name == "include")
 	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		std::string svalue;
-		std::vector<std::string> vec;
-
-		for (std::size_t i = 0U; i < str.size(); ++i)
+		std::string path;
+		for (const char& ch : args)
 		{
-			const char& ch = str[i];
-			switch (ch)
+			if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\"' || ch == '<' || ch == '>') continue;
+			else
 			{
-			case ',':
-				vec.push_back(svalue);
-				svalue.clear();
-				break;
-
-			default:
-				svalue += ch;
-				break;
+				path += ch;
 			}
 		}
 
-		vec.push_back(svalue);
-		svalue.clear();
+		this->include_file(path, state.line, file);
+	}
+	else if (name == "define" || name == "undef")
+	{
+		const std::size_t symbol_end = std::min(args.find_first_of(" \t"), args.size());
 
-		const std::size_t vsize = vec.size();
+		record_data record;
+		record.type = (name == "define") ? RECORD_DEFINE : RECORD_UNDEF;
+		record.name = std::string(args.substr(0U, symbol_end));
+		record.line = state.line;
 
-		if (vsize < 4u)
+		if (record.name.empty())
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have less than 4 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			this->report(file.index, state.line, "#" + std::string(name) + " without a symbol name!");
+			return true;
 		}
-		else if (vsize > 4u)
+
+		if (record.type == RECORD_DEFINE)
 		{
-			std::cout << "Section \"" << section << "\" key \"" << key << "\" have greater than 4 parameters! Return default value..." << "\n}" << std::endl;
-			return default_value;
+			std::string_view value = args.substr(symbol_end);
+			const std::size_t value_begin = value.find_first_not_of(" \t");
+			value = (value_begin != std::string_view::npos) ? value.substr(value_begin) : std::string_view("1");
+			if (value.size() >= 2U && value.front() == '\"' && value.back() == '\"') value = value.substr(1U, value.size() - 2U);
+
+			record.value = std::string(value);
+			this->set_symbol(record.name, record.value);
 		}
 		else
 		{
-			return Vec4u(std::stoul(vec[0]), std::stoul(vec[1]), std::stoul(vec[2]), std::stoul(vec[3]));
+			this->remove_symbol(record.name);
 		}
+
+		file.records.push_back(record);
 	}
 	else
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
+		return false;
 	}
+
+	return true;
 }
 
 
-const std::string& CFGParser::getString(const std::string& section, const std::string& key, const std::string& default_value) const
+const char* CFGParser::skip_block(const char* pos, const char* end, std::size_t& line)
 {
-	if (this->isSectionKeyExist(section, key))
-	{
-		const std::string& str = _buffer.at(section).at(key).value;
-		return str;
-	}
-	else
+	// Only lines starting with '#' matter, so the block is searched for '#' and lines aren't split at all.
+	const char* scan = pos;
+	while (scan < end)
 	{
-		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
-		return default_value;
-	}
-}
+		const char* hash = static_cast<const char*>(std::memchr(scan, '#', static_cast<std::size_t>(end - scan)));
+		if (!hash) break;
 
+		const char* start = hash;
+		while (start > pos && (start[-1] == ' ' || start[-1] == '\t')) start--;
 
-const std::size_t CFGParser::getSectionNum() const
-{
-	return _buffer.size();
+		if (start == pos || start[-1] == '\n')
+		{
+			line += static_cast<std::size_t>(std::count(pos, start, '\n'));
+			return start;
+		}
+
+		scan = hash + 1;
+	}
+
+	line += static_cast<std::size_t>(std::count(pos, end, '\n'));
+	return end;
 }
 
 
-const std::size_t CFGParser::getConfigNum(const std::string& section) const
+void CFGParser::include_file(const std::string& name, const std::size_t line, file_data& file)
 {
-	if(this->isSectionExist(section))
+	const std::string path = _includes.resolve(name, file.path, _cfg_base_path);
+	std::string error;
+
+	if (path.empty())
+	{
+		this->report(file.index, line, "Included file \"" + name + "\" not found!");
+	}
+	else if (!_includes.enter(path, error))
 	{
-		return _buffer.at(section).size();
+		this->report(file.index, line, error);
 	}
 	else
 	{
-		std::cout << "Section \"" << section << "\" doesn't exist!" << "\n}" << std::endl;
-		return 0U;
+		// Included file is parsed right away, so its symbols are known to the rest of this file.
+		record_data record;
+		record.type = RECORD_INCLUDE;
+		record.name = name;
+		record.line = line;
+		record.include = this->load_file(path);
+
+		_includes.leave();
+
+		if (record.include)
+		{
+			if (record.include->conditional) file.conditional = true;
+			file.records.push_back(record);
+		}
 	}
 }
 
 
-void CFGParser::setBaseConfigPath(const std::string& path)
+void CFGParser::prefetch_includes(const std::string& text, const std::string& path)
 {
-	_cfg_base_path = path;
-}
+	const char* pos = text.data();
+	const char* end = text.data() + text.size();
+	std::size_t line = 0U;
 
+	while ((pos = skip_block(pos, end, line)) < end)
+	{
+		const char* nl = static_cast<const char*>(std::memchr(pos, '\n', static_cast<std::size_t>(end - pos)));
+		const char* line_end = nl ? nl : end;
+		const std::string_view directive(pos, static_cast<std::size_t>(line_end - pos));
 
-const std::string& CFGParser::getBaseConfigPath() const
-{
-	return _cfg_base_path;
+		const std::size_t first = directive.find('#');
+		if (directive.compare(first, 8U, "#include") == 0)
+		{
+			std::string name;
+			for (const char& ch : directive.substr(first + 8U))
+			{
+				if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\"' || ch == '<' || ch == '>') continue;
+				else
+				{
+					name += ch;
+				}
+			}
+
+			// Includes inside inactive blocks are read for nothing, but never parsed.
+			const std::string resolved = _includes.resolve(name, path, _cfg_base_path);
+			if (!resolved.empty() && _file_cache.find(resolved) == _file_cache.end()) _reader.request(resolved);
+		}
+
+		pos = nl ? nl + 1 : end;
+	}
 }
 
 
-void CFGParser::debug()
+const bool CFGParser::evaluate(std::string_view condition) const
 {
-	for (section_map::const_iterator it = _buffer.begin(); it != _buffer.end(); ++it)
+	bool negate = false;
+	while (!condition.empty() && (condition.front() == '!' || condition.front() == ' ' || condition.front() == '\t'))
 	{
-		std::cout << "[" << (*it).first << "]" << std::endl;
-		for (value_map::const_iterator itr = (*it).second.begin(); itr != (*it).second.end(); ++itr)
+		if (condition.front() == '!') negate = !negate;
+		condition.remove_prefix(1U);
+	}
+
+	if (condition.compare(0U, 7U, "defined") == 0)
+	{
+		std::string name;
+		for (const char& ch : condition.substr(7U))
 		{
-			std::cout << (*itr).first << " = " << (*itr).second.value << std::endl;
+			if (ch != ' ' && ch != '\t' && ch != '(' && ch != ')') name += ch;
 		}
-		
-		std::cout << "\n" << std::endl;
+
+		return negate != (_symbols.find(name) != _symbols.end());
 	}
-}
 
-/////////////////////////////////////////////////////////////////////////////////
-//protected functions
-/////////////////////////////////////////////////////////////////////////////////
+	std::size_t compare = condition.find("==");
+	if (compare == std::string_view::npos) compare = condition.find("!=");
 
-void CFGParser::process_file(const std::string& cfg_file)
-{
-	std::fstream _file;
-	
-	_file.open(cfg_file, std::ios::in);
-	if (_file.good())
+	std::string name, value;
+	for (const char& ch : condition.substr(0U, compare))
 	{
-		std::string temp, section, preprocess, inherit_name, key, value;
+		if (ch != ' ' && ch != '\t') name += ch;
+	}
 
-		while (!_file.eof())
+	const std::unordered_map<std::string, std::string>::const_iterator it = _symbols.find(name);
+	bool result;
+
+	if (compare != std::string_view::npos)
+	{
+		for (const char& ch : condition.substr(compare + 2U))
 		{
-			_line++;
-			std::getline(_file, temp);
+			if (ch != ' ' && ch != '\t' && ch != '\"') value += ch;
+		}
 
-			if (temp.empty() || temp[0] == ';') continue;
+		result = (it != _symbols.end() && (*it).second == value);
+		if (condition[compare] == '!') result = !result;
+	}
+	else
+	{
+		result = (it != _symbols.end() && !(*it).second.empty() && (*it).second != "0" && (*it).second != "false" && (*it).second != "off" && (*it).second != "no");
+	}
 
-			if (temp.find("#include") != std::string::npos)
-			{
-				std::string path;
+	return negate != result;
+}
 
-				for (auto& ch : temp.substr(8u, temp.length() - 8u))
-				{
-					if (ch == ' ' || ch == '\t' || ch == '\"' || ch == '<' || ch == '>') continue;
-					else
-					{
-						path += ch;
-					}
-				}
-				
-				this->process_file(_cfg_base_path + path);
-			}
 
-			_ptype = KEY;
+void CFGParser::set_symbol(const std::string& name, const std::string& value)
+{
+	std::pair<std::unordered_map<std::string, std::string>::iterator, bool> result = _symbols.emplace(name, value);
+	if (!result.second)
+	{
+		_symbols_hash ^= pair_hash(name, (*result.first).second);
+		(*result.first).second = value;
+	}
 
-			const std::size_t line_length = temp.size();
+	_symbols_hash ^= pair_hash(name, value);
+}
 
-			for (std::size_t i = 0; i < line_length; ++i)
-			{
-				const char& chr = temp[i];
-				switch (chr)
-				{
-					case '[':
-						if (_ptype == STRING) value += '[';
-						else
-						{
-							_ptype = SECTION;
-							section.clear();
-						}
-					break;
 
-					case ']':
-						if (_ptype == STRING) value += ']';
-					break;
+void CFGParser::remove_symbol(const std::string& name)
+{
+	const std::unordered_map<std::string, std::string>::iterator it = _symbols.find(name);
+	if (it == _symbols.end()) return;
 
-					case '#':
-						if (_ptype == STRING) value += '#';
-						else
-						{
-							_ptype = PREPROCESSOR;
-							preprocess.clear();
-						}
-					break;
-	/*
-					case '<':
-						if (_ptype == PREPROCESSOR)
-						{
+	_symbols_hash ^= pair_hash(name, (*it).second);
+	_symbols.erase(it);
+}
 
-							for (std::size_t nm = i; nm < line_length; nm++)
-							{
-								if (temp.at(nm) == '>')
-								{
-									break;
-								}
-								else
-								{
 
-								}
-							}
+void CFGParser::replay_symbols(const file_data& file)
+{
+	for (const record_data& record : file.records)
+	{
+		if (record.type == RECORD_DEFINE) this->set_symbol(record.name, record.value);
+		else if (record.type == RECORD_UNDEF) this->remove_symbol(record.name);
+		else if (record.type == RECORD_INCLUDE && record.include) this->replay_symbols(*record.include);
+	}
+}
 
-							i = (line_length - 1U);
-						}
-					break;
 
-					case '>':
+void CFGParser::insert_value(const std::string& section, const std::string& key, const value_data& data)
+{
+	const bool fold = (_options & CASE_INSENSITIVE) != 0U;
 
-					break;
-	*/
-					case ':':
-						if (_ptype == SECTION)
-						{
-							_ptype = INHERIT;//Если у нас все еще секция, то можно наследовать конфиги
-#ifdef DEBUG
-							std::cout << "Inheriting from \"";// << std::std::endl;
-#endif
-						}
-						else if (_ptype == STRING)
-						{
-							value += ':';
-						}
-					break;
+	section_map::iterator it = _buffer.find(section);
+	if (it == _buffer.end())
+	{
+		std::string name = section;
+		if (fold) std::transform(name.begin(), name.end(), name.begin(), fold_char);
 
-					case '=':
-						if (_ptype == STRING) value += '=';
-						else _ptype = VALUE;
-					break;
+		it = _buffer.emplace(name, std::make_shared<section_data>(fold)).first;
+		_order.push_back(&(*it));
 
-					case ';':
-						if (_ptype == STRING) value += ';';
-						else i = (line_length - 1U);
-					break;
+		if ((_options & NAME_INDEX) != 0U) _section_index.insert((*it).first, (*it).first);
+	}
 
-					case '\"':
-						if (_ptype == VALUE)
-						{
-							_ptype = STRING;
-						}
-						else if(_ptype == STRING)
-						{
-							_ptype = KEY;
-						}
-					break;
+	// Redefined keys keep the position of their first definition.
+	section_data& sec = this->writable_section(it);
+	value_map& values = sec.values;
+	value_map::iterator itr = values.find(key);
+	if (itr != values.end())
+	{
+		sec.content ^= pair_hash((*itr).first, (*itr).second.value);
+		(*itr).second = data;
+	}
+	else
+	{
+		std::string name = key;
+		if (fold) std::transform(name.begin(), name.end(), name.begin(), fold_char);
 
-					case ' ':
-						if (_ptype == STRING) value += ' ';
-					break;
+		itr = values.emplace(name, data).first;
+		sec.order.push_back(&(*itr));
 
-					case '\t':
-						if (_ptype == STRING) value += '\t';
-					break;
+		if ((_options & NAME_INDEX) != 0U) _key_index.insert((*it).first + '\0' + (*itr).first, (*itr).first);
+	}
 
-					case '\\':
-						if (_ptype == STRING && (temp.size() > (i + 1)))
-						{				
-							const char& next_char = temp[i + 1];
+	(*itr).second.state = ((*itr).second.value.find('$') != std::string::npos) ? VALUE_UNRESOLVED : VALUE_PLAIN;
+	if ((*itr).second.state != VALUE_PLAIN) sec.references = true;
+	sec.content ^= pair_hash((*itr).first, (*itr).second.value);
+}
 
-							switch (next_char)
-							{
-								case 'n':
-									value += '\n';
-								break;
 
-								case 't':
-									value += '\t';
-								break;
+void CFGParser::copy_order(const CFGParser& other)
+{
+	const bool indexed = (_options & NAME_INDEX) != 0U;
 
-								case '\"':
-									value += '\"';
-								break;
+	_order.clear();
+	_order.reserve(other._order.size());
+	_section_index.clear();
+	_key_index.clear();
 
-								case '\'':
-									value += '\'';
-								break;
+	for (const section_map::value_type* sec : other._order)
+	{
+		section_map::iterator it = _buffer.find(sec->first);
+		_order.push_back(&(*it));
 
-								case '\\':
-									value += '\\';
-								break;
+		if (indexed)
+		{
+			_section_index.insert((*it).first, (*it).first);
+			for (const value_map::value_type* val : (*it).second->order) _key_index.insert((*it).first + '\0' + val->first, val->first);
+		}
+	}
+}
 
-								default:
-									std::cout << "Unknown escape character! Line: " << _line << "\n}" << std::endl;
-								break;
-							}
 
-							i++;
-						}
-					break;
+CFGParser::section_data& CFGParser::writable_section(const section_map::iterator& it)
+{
+	if ((*it).second.use_count() > 1)
+	{
+		(*it).second = copy_section(*(*it).second);
 
-					default:
-					{
-						switch (_ptype)
-						{
-							case SECTION:
-								section += chr;
-							break;
+		// Name index viewed the keys of the shared copy.
+		if ((_options & NAME_INDEX) != 0U)
+		{
+			for (const value_map::value_type* val : (*it).second->order) _key_index.insert((*it).first + '\0' + val->first, val->first);
+		}
+	}
 
-							case KEY:
-								key += chr;
-							break;
+	return *(*it).second;
+}
 
-							case VALUE:
-								value += chr;
-							break;
 
-							case STRING:
-								value += chr;
-							break;
+const CFGParser::section_ptr CFGParser::copy_section(const section_data& section)
+{
+	const section_ptr copy = std::make_shared<section_data>(section);
 
-							case PREPROCESSOR:
-								preprocess += chr;
-							break;
+	copy->order.clear();
+	copy->order.reserve(section.order.size());
+	for (const value_map::value_type* val : section.order) copy->order.push_back(&(*copy->values.find(val->first)));
 
-							case INHERIT:
-								inherit_name += chr;
-							break;
-						}
-					}
-					break;
-				}
-			}
+	return copy;
+}
 
-			//////////////////////////////////////////////////////
-			//Errors check
-			//////////////////////////////////////////////////////
-			
-			const bool section_empty = section.empty();
-			const bool inherit_empty = inherit_name.empty();
-			const bool key_empty = key.empty();
-			const bool value_empty = value.empty();
-			const bool preproces_empty = preprocess.empty();
-
-			if (section_empty && _ptype == SECTION) std::cout << "Syntax error! Section name is empty at line " << _line << "!" << "\n}" << std::endl;
-			if (inherit_empty && _ptype == INHERIT) std::cout << "Syntax error! Inherit name is empty at line " << _line << "!" << "\n}" << std::endl;
-			if (key_empty && _ptype == KEY && _ptype != SECTION) std::cout << "Syntax error! Key string is empty at line " << _line << "!" << "\n}" << std::endl;
-			if (value_empty && _ptype == KEY) std::cout << "Syntax error! Line doesn't have a \'=\' symbol at line " << _line << "!" << "\n}" << std::endl;
-			if (value_empty && _ptype == VALUE) std::cout << "Can't find value at line " << _line << "!" << "\n}" << std::endl;
-			if (preproces_empty && _ptype == PREPROCESSOR) std::cout << "Syntax error! Preprocessor command is empty at line " << _line << "!" << "\n}" << std::endl;
-			//////////////////////////////////////////////////////
-
-			if (_ptype == PREPROCESSOR && !preproces_empty)
-			{
 
-			}
+void CFGParser::copy_sections(const section_map& from, section_map& to, const bool share)
+{
+	to.reserve(from.size());
+	for (const section_map::value_type& sec : from)
+	{
+		to.emplace(sec.first, share ? sec.second : copy_section(*sec.second));
+	}
+}
 
-			if (_ptype == INHERIT && !inherit_empty)
-			{
-#ifdef DEBUG
-				std::cout << inherit_name << "\" to section \"" << section << "\"..." << std::endl;
-#endif
 
-				if (this->isSectionExist(inherit_name))
-				{
-					for (value_map::const_iterator itr = _buffer.at(inherit_name).begin(); itr != _buffer.at(inherit_name).end(); ++itr)
-					{
-						value_data data;
-						data.value = (*itr).second.value;
-						data.line = _line;
-						const std::string& key_name = (*itr).first;
-						_buffer[section][key_name] = data;
-					}
-				}
-				else
-				{
-					std::cout << "Inherited section \"" << inherit_name << "\" not exist!" << "\n}" << std::endl;
-				}
+const std::string CFGParser::fold_name(const std::string& name) const
+{
+	std::string folded = name;
+	if ((_options & CASE_INSENSITIVE) != 0U) std::transform(folded.begin(), folded.end(), folded.begin(), fold_char);
 
-				inherit_name.clear();
-				_ptype = KEY;
-			}
+	return folded;
+}
 
-			value_data data;
-			data.value = value;
-			data.line = _line;
 
-			if (!section_empty && _ptype != SECTION && !key_empty)
-			{
-				_buffer[section][key] = data; // Errors check?
+const std::vector<std::string_view> CFGParser::scan_names(const std::string& section, const std::string& pattern, const bool prefix) const
+{
+	const std::string folded = this->fold_name(pattern);
+	std::vector<std::string_view> result;
 
-				key.clear();
-				value.clear();
-			}
-		}	
+	auto check = [&](const std::string& name)
+	{
+		if (prefix ? (name.compare(0U, folded.size(), folded) == 0) : CFGRadixTree::match(folded, name)) result.push_back(name);
+	};
+
+	if (section.empty())
+	{
+		for (const section_map::value_type* sec : _order) check(sec->first);
 	}
 	else
 	{
-		std::cout << "File \"" << cfg_file << "\" not be opened!" << "\n" << std::endl;
+		const section_map::const_iterator it = _buffer.find(section);
+		if (it != _buffer.end())
+		{
+			for (const value_map::value_type* val : (*it).second->order) check(val->first);
+		}
 	}
-	
-	_file.close();	
-	
+
+	std::sort(result.begin(), result.end());
+	return result;
 }
@@ -25,29 +25,153 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <future>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <atomic>
+
+#include "CFGRadixTree.hpp"
+#include "CFGInclude.hpp"
+#include "CFGReader.hpp"
+#include "CFGEnum.hpp"
+#include "CFGSchema.hpp"
+#include "CFGAllocator.hpp"
 
 #ifdef USE_GLM
   #include "glm/vec2.hpp"
   #include "glm/vec3.hpp"
   #include "glm/vec4.hpp"
 
-  typedef Vec2 Vec2;
-  typedef Vec3 Vec3;
-  typedef Vec4 Vec4;
-  typedef Vec2i Vec2i;
-  typedef Vec3i Vec3i;
-  typedef Vec4i Vec4i;
-  typedef Vec2u Vec2u;
-  typedef Vec3u Vec3u;
+  typedef glm::vec2 Vec2;
+  typedef glm::vec3 Vec3;
+  typedef glm::vec4 Vec4;
+  typedef glm::ivec2 Vec2i;
+  typedef glm::ivec3 Vec3i;
+  typedef glm::ivec4 Vec4i;
+  typedef glm::uvec2 Vec2u;
+  typedef glm::uvec3 Vec3u;
   typedef glm::uvec4 Vec4u;
+
+  // glm::aligned_vec3 needs GLM_FORCE_ALIGNED_GENTYPES and language extensions in every
+  // translation unit, so the aligned vectors only add alignment to the plain GLM types.
+  struct alignas(16) Vec3a : glm::vec3
+  {
+	using glm::vec3::vec3;
+	Vec3a() : glm::vec3(0.0f) {}
+  };
+
+  struct alignas(16) Vec4a : glm::vec4
+  {
+	using glm::vec4::vec4;
+	Vec4a() : glm::vec4(0.0f) {}
+  };
 #else
   #include "vector.hpp"
 #endif
 
+static_assert(alignof(Vec3a) == 16U && sizeof(Vec3a) == 16U, "Vec3a must be one aligned SIMD register");
+static_assert(alignof(Vec4a) == 16U && sizeof(Vec4a) == 16U, "Vec4a must be one aligned SIMD register");
+
+
+/**
+	@brief Describes a vector type for getVector(): type and number of components.
+
+	data() returns the first component, the others must follow it in memory.
+	Specialize it to read straight into own math types:
+
+	@code
+	template<> struct vector_traits<MyFloat4> : vector_layout<float, 4U>
+	{
+		static float* data(MyFloat4& value) { return value.v; }
+	};
+	@endcode
+*/
+template<typename T> struct vector_traits;
+
+template<typename C, std::size_t N> struct vector_layout
+{
+	typedef C component_type;
+	static constexpr std::size_t size = N;
+};
+
+template<> struct vector_traits<Vec2> : vector_layout<float, 2U> { static float* data(Vec2& value) { return &value.x; } };
+template<> struct vector_traits<Vec3> : vector_layout<float, 3U> { static float* data(Vec3& value) { return &value.x; } };
+template<> struct vector_traits<Vec4> : vector_layout<float, 4U> { static float* data(Vec4& value) { return &value.x; } };
+template<> struct vector_traits<Vec2i> : vector_layout<int, 2U> { static int* data(Vec2i& value) { return &value.x; } };
+template<> struct vector_traits<Vec3i> : vector_layout<int, 3U> { static int* data(Vec3i& value) { return &value.x; } };
+template<> struct vector_traits<Vec4i> : vector_layout<int, 4U> { static int* data(Vec4i& value) { return &value.x; } };
+template<> struct vector_traits<Vec2u> : vector_layout<unsigned int, 2U> { static unsigned int* data(Vec2u& value) { return &value.x; } };
+template<> struct vector_traits<Vec3u> : vector_layout<unsigned int, 3U> { static unsigned int* data(Vec3u& value) { return &value.x; } };
+template<> struct vector_traits<Vec4u> : vector_layout<unsigned int, 4U> { static unsigned int* data(Vec4u& value) { return &value.x; } };
+template<> struct vector_traits<Vec3a> : vector_layout<float, 3U> { static float* data(Vec3a& value) { return &value.x; } };
+template<> struct vector_traits<Vec4a> : vector_layout<float, 4U> { static float* data(Vec4a& value) { return &value.x; } };
+
+
+/**
+	@brief Suffix of a value with unit and its factor to the canonical unit. Empty name is a bare number.
+*/
+struct unit_suffix
+{
+	const char* name;
+	double scale;
+};
+
+/**
+	@brief Describes a unit for getUnit(): type of the canonical value and the known suffixes.
+
+	Values are a number(decimal, with fraction or exponent, or hex with "0x") followed by
+	a suffix of the table, spaces between are allowed. Suffixes are case-sensitive.
+	Integer values are rounded and checked against the range of the type.
+	Own units are added by a tag type and a specialization:
+
+	@code
+	struct unit_angle {};
+	template<> struct unit_traits<unit_angle>
+	{
+		typedef double value_type;	// radians
+		static constexpr unit_suffix suffixes[] = { { "", 1.0 }, { "rad", 1.0 }, { "deg", 0.0174532925199432958 } };
+	};
+
+	const double fov = cfg.getUnit<unit_angle>("camera", "fov");
+	@endcode
+*/
+template<typename U> struct unit_traits;
+
+struct unit_size {};		// bytes, binary multiples: 512MB, 4 KiB, 1.5G
+struct unit_duration {};	// seconds: 250ms, 1.5h, 30
+struct unit_percent {};		// fraction: 75% or 0.75
+
+template<> struct unit_traits<unit_size>
+{
+	typedef std::uint64_t value_type;
+	static constexpr unit_suffix suffixes[] = { { "", 1.0 }, { "B", 1.0 },
+		{ "K", 1024.0 }, { "KB", 1024.0 }, { "KiB", 1024.0 },
+		{ "M", 1048576.0 }, { "MB", 1048576.0 }, { "MiB", 1048576.0 },
+		{ "G", 1073741824.0 }, { "GB", 1073741824.0 }, { "GiB", 1073741824.0 },
+		{ "T", 1099511627776.0 }, { "TB", 1099511627776.0 }, { "TiB", 1099511627776.0 } };
+};
+
+template<> struct unit_traits<unit_duration>
+{
+	typedef double value_type;
+	static constexpr unit_suffix suffixes[] = { { "", 1.0 }, { "s", 1.0 },
+		{ "ns", 1e-9 }, { "us", 1e-6 }, { "ms", 1e-3 }, { "m", 60.0 }, { "min", 60.0 }, { "h", 3600.0 }, { "d", 86400.0 } };
+};
+
+template<> struct unit_traits<unit_percent>
+{
+	typedef double value_type;
+	static constexpr unit_suffix suffixes[] = { { "", 1.0 }, { "%", 0.01 } };
+};
 
 /**
 	@brief class for parsing CFG configs in ini-style.
@@ -59,15 +183,27 @@
 	- Vector values are separated by commas(64, 128, 255).
 	- Section inheritance is supported(single for now).
 	- File inclde is supported.
+	- Values can reference other values: ${section:key} or ${key} from the same section.
+	  References are expanded when the config is loaded or changed, "$$" gives a plain '$'.
+	  Reading never writes to the parser.
+	- Conditional blocks: #if, #ifdef, #ifndef, #elif, #else, #endif, driven by symbols
+	  from define() and by #define/#undef in the files. Skipped blocks aren't tokenized.
 	
 	The syntax is simple:
 	@code
 	#include "path_of_the_file_to_include"
 	
+	#ifdef WINDOWS
+	#include "windows.ini"
+	#elif PLATFORM == linux
+	#include "linux.ini"
+	#endif
+	
 	[section_name]
 	key = value
 	key_string = "some text"
 	key_vector = 53.74, 632.83, 146.013
+	key_path = ${paths:root}/textures
 	
 	[section_name] : inherited_section_name
 	key = value
@@ -77,17 +213,97 @@ class CFGParser
 {
 public:
 
+	/**
+		@brief Parser options, can be combined.
+	*/
+	enum Options
+	{
+		CASE_INSENSITIVE = 0x01,	// Section and key names match regardless of ASCII case. Names are stored lowercased.
+		NAME_INDEX = 0x02,			// Keep radix trees over section and key names for find* queries.
+		VALIDATE_UTF8 = 0x04,		// Reject files, which aren't valid UTF-8. ASCII parts are checked 16 bytes at a time.
+		PARALLEL_PARSE = 0x08		// Tokenize big files without directives on several threads, split at lines starting with '['.
+	};
+
 	/**
 		@brief Constructor.
 		@param Config file path.
+		@param Combination of Options.
+	*/
+	CFGParser(const std::string& cfg_file, const unsigned int options = 0U);
+
+	/**
+		@brief Constructor of an empty parser, call load() after setting it up.
+		@param Combination of Options.
 	*/
-	CFGParser(const std::string& cfg_file);
+	explicit CFGParser(const unsigned int options = 0U);
 	
+	/**
+		@brief Copy constructor.
+	*/
+	CFGParser(const CFGParser& other);
+
 	/**
 		@brief Destructor.
 	*/
 	virtual ~CFGParser();
 
+	/**
+		@brief Copy assignment.
+	*/
+	CFGParser& operator=(const CFGParser& other);
+
+	/**
+		@brief Parse config file, replacing everything parsed before. Overrides are kept.
+
+		Every file is parsed once per load, even if it's included many times. Include
+		cycles and too deep includes are reported to getErrors() and skipped.
+		Return false, if nothing could be read.
+	*/
+	const bool load(const std::string& cfg_file);
+
+	/**
+		@brief Run load() on another thread. The parser must not be used until the future is ready.
+
+		@code
+		std::future<bool> loaded = cfg.loadAsync("server.ini");
+		// ...other initialization...
+		if (loaded.get()) start(cfg);
+		@endcode
+	*/
+	std::future<bool> loadAsync(const std::string& cfg_file);
+
+	/**
+		@brief Add directory, where included files are searched after the base path and the including file's directory.
+	*/
+	void addIncludePath(const std::string& path);
+
+	/**
+		@brief Set how deep includes can be nested(32 by default).
+	*/
+	void setMaxIncludeDepth(const std::size_t depth);
+
+	/**
+		@brief Define symbol for conditional blocks of the next load.
+
+		Supported conditions: "#if NAME"(defined and not 0/false/off/no), "#if !NAME",
+		"#if NAME == value", "#if NAME != value", "#if defined(NAME)", "#ifdef NAME", "#ifndef NAME".
+		Symbols defined by the files themselves live until the end of the load.
+	*/
+	void define(const std::string& name, const std::string& value = "1");
+
+	/**
+		@brief Remove symbol, defined with define().
+	*/
+	void undefine(const std::string& name);
+
+	/**
+		@brief Short check, defined symbol with define() or not.
+	*/
+	inline const bool isDefined(const std::string& name) const
+	{
+		return (_defines.find(name) != _defines.end()) ? true : false;
+	}
+
 	/**
 		@brief Return bool value. Otherwise return default value.
 	*/
@@ -163,6 +379,26 @@ public:
 	*/
 	const std::string& getString(const std::string& section, const std::string& key, const std::string& default_value = "empty_string") const;
 
+	/**
+		@brief Decoded binary value, points into the parser. Empty, if key doesn't exist or can't be decoded.
+	*/
+	struct blob_data
+	{
+		const unsigned char* data;
+		std::size_t size;
+	};
+
+	/**
+		@brief Return binary value, written as base64 or as hex with "hex:" prefix("base64:" prefix is optional).
+
+		The value is decoded on the first read and kept, the next reads return the same
+		memory without copying, so blobs nobody reads cost nothing. Threads reading one
+		parser may decode the same value at once, one result is published with an atomic
+		pointer and the others are dropped. Decoding uses SSSE3 for base64 and SSE2 for
+		hex, when they're enabled for the build.
+	*/
+	const blob_data getBlob(const std::string& section, const std::string& key) const;
+
 	/**
 		@brief Return Vec2f value. Otherwise return default value.
 	*/
@@ -208,6 +444,110 @@ public:
 	*/
 	const Vec4u getVec4u(const std::string& section, const std::string& key, const Vec4u& default_value = Vec4u(0U)) const;
 
+	/**
+		@brief Return vector of any type with vector_traits(GLM, aligned or own types). Otherwise return default value.
+
+		@code
+		const Vec4a color = cfg.getVector<Vec4a>("light", "color");
+		@endcode
+	*/
+	template<typename T> const T getVector(const std::string& section, const std::string& key, const T& default_value = T()) const
+	{
+		return this->get_value(section, key, default_value);
+	}
+
+	/**
+		@brief Return value with unit, converted to the canonical unit of the traits. Otherwise return default value.
+
+		Keys of the schema with a size, duration or percent type are parsed when they're
+		loaded or changed and the canonical value is kept, other values are parsed on every
+		read. Whole numbers of integral units are kept exact, also above 2^53.
+	*/
+	template<typename U> const typename unit_traits<U>::value_type getUnit(const std::string& section, const std::string& key, const typename unit_traits<U>::value_type& default_value = 0) const
+	{
+		const value_data* data = this->find_value(section, key);
+		if (!data)
+		{
+			std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+			return default_value;
+		}
+
+		typename unit_traits<U>::value_type value;
+		if (this->unit_value<U>(*data, section, value)) return value;
+
+		std::cout << "Can't convert string \"" << this->value_of(*data, section) << "\" of section \"" << section << "\" key \"" << key << "\" to value! Return to default value..." << "\n}" << std::endl;
+		return default_value;
+	}
+
+	/**
+		@brief Return enum value by one of its names from enum_traits. Otherwise return default value.
+
+		Names are found by a perfect hash, built at compile time, so a read is one hash and
+		one compare, without allocations.
+
+		@code
+		const LogLevel level = cfg.getEnum("log", "level", LOG_INFO);
+		@endcode
+	*/
+	template<typename E> const E getEnum(const std::string& section, const std::string& key, const E default_value = E()) const
+	{
+		const value_data* data = this->find_value(section, key);
+		if (!data)
+		{
+			std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+			return default_value;
+		}
+
+		E value;
+		if (this->enum_value(*data, section, value)) return value;
+
+		std::cout << "Unknown name \"" << this->value_of(*data, section) << "\" of section \"" << section << "\" key \"" << key << "\"! Return to default value..." << "\n}" << std::endl;
+		return default_value;
+	}
+
+	/**
+		@brief Return size in bytes(512MB, 4KiB, 1.5G). Otherwise return default value.
+	*/
+	inline const std::uint64_t getSize(const std::string& section, const std::string& key, const std::uint64_t default_value = 0U) const
+	{
+		return this->getUnit<unit_size>(section, key, default_value);
+	}
+
+	/**
+		@brief Return duration in seconds(250ms, 1.5h, 30). Otherwise return default value.
+	*/
+	inline const double getDuration(const std::string& section, const std::string& key, const double default_value = 0.0) const
+	{
+		return this->getUnit<unit_duration>(section, key, default_value);
+	}
+
+	/**
+		@brief Return percentage as fraction(75% and 0.75 both give 0.75). Otherwise return default value.
+	*/
+	inline const double getPercent(const std::string& section, const std::string& key, const double default_value = 0.0) const
+	{
+		return this->getUnit<unit_percent>(section, key, default_value);
+	}
+
+	/**
+		@brief Read vectors of many keys of one section into structure-of-arrays buffers. Return number of keys, which were written.
+
+		Component c of the i-th key goes to components[c][i], for c below size. Buffers of
+		keys which don't exist or can't be converted are left as is, so they may be filled
+		with defaults before the call. The buffers can be used for SIMD math or GPU upload
+		without repacking.
+
+		@code
+		float x[64], y[64], z[64];
+		float* components[] = { x, y, z };
+		cfg.getVectors("spawn", names.data(), names.size(), 3U, components);
+		@endcode
+	*/
+	const std::size_t getVectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, float* const* components) const;
+	const std::size_t getVectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, double* const* components) const;
+	const std::size_t getVectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, int* const* components) const;
+	const std::size_t getVectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, unsigned int* const* components) const;
+
 	/**
 		@brief Template function. With this you can get any numeric value(nothing more!). Work with std::istringstream SEAL_CLASS_ALIGN class.
 	*/
@@ -215,9 +555,10 @@ public:
 	{
 		T value = 0;
 		
-		if (this->isSectionKeyExist(section, key))
+		const value_data* data = this->find_value(section, key);
+		if (data)
 		{
-			const std::string& str = _buffer.at(section).at(key).value;
+			const std::string& str = this->value_of(*data, section);
 
 			std::istringstream stream(str);
 			if (stream.fail() || stream.bad())
@@ -238,6 +579,76 @@ public:
 		}
 	}
 
+	/**
+		@brief Type of the variable, written by getValues().
+	*/
+	enum ValueType
+	{
+		TYPE_BOOL = 0x01,
+		TYPE_CHAR,
+		TYPE_UCHAR,
+		TYPE_SHORT,
+		TYPE_USHORT,
+		TYPE_INT,
+		TYPE_UINT,
+		TYPE_LONG,
+		TYPE_ULONG,
+		TYPE_LLONG,
+		TYPE_ULLONG,
+		TYPE_FLOAT,
+		TYPE_DOUBLE,
+		TYPE_LDOUBLE,
+		TYPE_STRING,		// std::string
+		TYPE_VEC2F,
+		TYPE_VEC2I,
+		TYPE_VEC2U,
+		TYPE_VEC3F,
+		TYPE_VEC3I,
+		TYPE_VEC3U,
+		TYPE_VEC4F,
+		TYPE_VEC4I,
+		TYPE_VEC4U
+	};
+
+	/**
+		@brief One read of getValues().
+	*/
+	struct value_query
+	{
+		std::string section;
+		std::string key;
+		ValueType type;
+		void* value;		// variable of the type. Left as is, if key doesn't exist or can't be converted.
+		bool found;			// set by getValues()
+	};
+
+	/**
+		@brief Read many keys in one call. Return number of variables, which were written.
+
+		All names are hashed before the first lookup, and in frozen mode the table slots
+		are prefetched, so the cache misses of the reads overlap instead of following
+		one another. Queries of the same section share one section lookup.
+
+		@code
+		float gravity = 9.81f;
+		int steps = 4;
+		std::vector<CFGParser::value_query> queries = {
+			{ "physics", "gravity", CFGParser::TYPE_FLOAT, &gravity },
+			{ "physics", "steps", CFGParser::TYPE_INT, &steps }
+		};
+		cfg.getValues(queries);
+		@endcode
+	*/
+	const std::size_t getValues(value_query* queries, const std::size_t count) const;
+
+	/**
+		@brief Read many keys in one call. Return number of variables, which were written.
+	*/
+	inline const std::size_t getValues(std::vector<value_query>& queries) const
+	{
+		return this->getValues(queries.data(), queries.size());
+	}
+
 	/**
 		@brief Return number of sections.
 	*/
@@ -271,16 +682,183 @@ public:
 	*/
 	inline const bool isSectionKeyExist(const std::string& section, const std::string& key) const
 	{
-		return (_buffer.find(section) != _buffer.end()) ? ((_buffer.at(section).find(key) != _buffer.at(section).end()) ? true : false) : false;
+		return (this->find_value(section, key) != nullptr) ? true : false;
+	}
+
+	/**
+		@brief Rebuild lookup into a compact read-only table.
+
+		All (section, key) pairs go into a minimal perfect hash: one slot per key,
+		with no empty slots and no probing. A 16-byte slot holds a 64-bit fingerprint
+		of the names and a pointer to the value, so a lookup is one hash, one slot read,
+		one compare and the read of the value. Values aren't copied, the table only
+		indexes them, and the ordered index keeps working. References inside values
+		are expanded here, so reading a frozen parser never changes it, and overrides
+		set later don't change them. Return false, if the table can't be built.
+	*/
+	const bool freeze();
+
+	/**
+		@brief Change or add value of the parsed config. Return false for a frozen parser.
+
+		Copies of a parser share all sections until they are changed: set() copies only
+		the section it writes to. That makes a copy per request or per thread cheap.
+		Only the values, which reference the changed key through ${...}, are expanded
+		again, and their sections are copied then too.
+
+		@code
+		CFGParser what_if = base;	// no sections are copied here
+		what_if.set("limits", "max_users", "500");
+		@endcode
+	*/
+	const bool set(const std::string& section, const std::string& key, const std::string& value);
+
+	/**
+		@brief Override single value without touching parsed config. Overrides are checked first by all getters.
+	*/
+	void setOverride(const std::string& section, const std::string& key, const std::string& value);
+
+	/**
+		@brief Take overrides from environment variables named prefix + section + "__" + key.
+
+		For example CFG_render__shadow_bias=0.5 overrides key "shadow_bias" of section "render".
+		Return number of taken overrides.
+	*/
+	const std::size_t loadEnvironmentOverrides(const std::string& prefix = "CFG_");
+
+	/**
+		@brief Take overrides from command line arguments "--set section.key=value" or "--set=section.key=value".
+
+		Section is split at the last dot, so "net.http.port=80" is key "port" of section "net.http".
+		Other arguments are skipped. Return number of taken overrides.
+	*/
+	const std::size_t loadArgumentOverrides(const int argc, const char* const* argv);
+
+	/**
+		@brief Remove all overrides.
+	*/
+	void clearOverrides();
+
+	/**
+		@brief Return number of overridden values.
+	*/
+	const std::size_t getOverrideNum() const;
+
+	/**
+		@brief Problem found while parsing or reading values.
+	*/
+	struct error_data
+	{
+		std::string file;
+		std::size_t line;
+		std::string message;
+	};
+
+	/**
+		@brief Return all problems reported so far, in the order they were found.
+	*/
+	inline const std::vector<error_data>& getErrors() const
+	{
+		return _errors;
+	}
+
+	/**
+		@brief Schema, which every following load() is checked against. nullptr turns checking off.
+
+		The schema isn't copied, it must live as long as the parser uses it.
+	*/
+	void setSchema(const CFGSchema* schema);
+
+	/**
+		@brief Check values against the schema in one pass. Violations go to getErrors() with their file and line.
+
+		Overridden values are checked instead of the values they hide. Values with units
+		keep their converted value, so getters of them don't parse again. Other types are
+		converted by their getters, as the type of the getter decides the range.
+		It adds to the errors, so it must not run while other threads read the parser.
+		Return number of violations.
+	*/
+	const std::size_t validate(const CFGSchema& schema);
+
+	/**
+		@brief Bytes held by the parser, by kind and by source file.
+
+		Strings are counted by their capacity, tables by their buckets and nodes as laid out
+		by common standard libraries. Build with CFG_TRACK_MEMORY to count buckets and nodes
+		of the section and value tables by an allocator instead, exact is set then. Strings,
+		sections, caches, indexes and the split by file are computed either way. Allocator
+		headers aren't counted.
+	*/
+	struct memory_data
+	{
+		std::size_t strings;	// heap of names and values
+		std::size_t buckets;	// bucket arrays of hash tables
+		std::size_t nodes;		// nodes of hash tables
+		std::size_t sections;	// section objects and their key order
+		std::size_t caches;		// expanded references, decoded blobs
+		std::size_t indexes;	// frozen table, name indexes and section order
+		std::size_t shared;		// part of the total in sections shared with copies of this parser
+		std::size_t total;
+		bool exact;				// buckets and nodes were counted by the allocator
+		std::vector<std::pair<std::string, std::size_t> > files; // keys, values and their nodes per source, like getErrors() names them
+	};
+
+	/**
+		@brief Return memory footprint of the parsed config.
+	*/
+	const memory_data getMemoryUsage() const;
+
+	/**
+		@brief Return options the parser was created with.
+	*/
+	inline const unsigned int getOptions() const
+	{
+		return _options;
+	}
+
+	/**
+		@brief Return true, if lookups go through the frozen table.
+	*/
+	inline const bool isFrozen() const
+	{
+		return (_frozen != nullptr) ? true : false;
 	}
 
 	/**
-		@brief For debug only. Prints all configs to console.
+		@brief Return names of sections matching the wildcard pattern('*' and '?'), sorted.
+		
+		With NAME_INDEX option the query visits only the matching part of the name tree,
+		otherwise all sections are scanned.
+	*/
+	const std::vector<std::string_view> findSections(const std::string& pattern) const;
+
+	/**
+		@brief Return names of sections starting with prefix, sorted.
+	*/
+	const std::vector<std::string_view> findSectionsByPrefix(const std::string& prefix) const;
+
+	/**
+		@brief Return names of keys of the section matching the wildcard pattern('*' and '?'), sorted.
+	*/
+	const std::vector<std::string_view> findKeys(const std::string& section, const std::string& pattern) const;
+
+	/**
+		@brief Return names of keys of the section starting with prefix, sorted.
+	*/
+	const std::vector<std::string_view> findKeysByPrefix(const std::string& section, const std::string& prefix) const;
+
+	/**
+		@brief For debug only. Prints all configs to console in file order.
 	*/
 	void debug();
 
 protected:
 
+	friend class CFGStack;
+	friend class CFGSnapshot;
+	friend class CFGDiff;
+	friend class CFGPushParser;
+
 	enum ProcessType
 	{
 		SECTION = 0x01,
@@ -291,22 +869,834 @@ protected:
 		PREPROCESSOR = 0x06
 	};
 
-	struct value_data
+	static const std::uint64_t hash_name(const char* str, const std::size_t size, const std::uint64_t seed, const bool fold);
+
+	static inline const std::uint64_t hash_mix(std::uint64_t value)
 	{
-		std::string value;
-		std::size_t line;
-	};
+		value ^= value >> 33U;
+		value *= 0xFF51AFD7ED558CCDULL;
+		value ^= value >> 33U;
+		value *= 0xC4CEB9FE1A85EC53ULL;
+		value ^= value >> 33U;
+		return value;
+	}
+
+	// Order-independent sets(symbols, section contents) are hashed as xor of their pairs.
+	static inline const std::uint64_t pair_hash(const std::string& name, const std::string& value)
+	{
+		return hash_mix(hash_name(value.data(), value.size(), hash_name(name.data(), name.size(), 0U, false), false));
+	}
 
-	typedef std::unordered_map<std::string, value_data> value_map;
-	typedef std::unordered_map<std::string, value_map> section_map;
+	static inline const char fold_char(const char chr)
+	{
+		return (chr >= 'A' && chr <= 'Z') ? static_cast<char>(chr + ('a' - 'A')) : chr;
+	}
 
-	void process_file(const std::string& cfg_file);
+	// Lowercase eight ASCII letters at once, other bytes are left as is.
+	static inline const std::uint64_t fold_word(const std::uint64_t word)
+	{
+		const std::uint64_t ones = 0x0101010101010101ULL;
+		const std::uint64_t high = 0x8080808080808080ULL;
+		const std::uint64_t heptets = word & ~high;
+		const std::uint64_t above_a = heptets + ones * (0x80U - 'A');
+		const std::uint64_t above_z = heptets + ones * (0x7FU - 'Z');
+		return word | ((((above_a ^ above_z) & ~word) & high) >> 2U);
+	}
+
+	/**
+		Hash and compare for section and key names. With fold they ignore ASCII case,
+		without building folded copies of the queried names.
+	*/
+	struct name_hash
+	{
+		explicit name_hash(const bool fold_case = false) : fold(fold_case) {}
+
+		inline const std::size_t operator()(const std::string& name) const
+		{
+			return static_cast<std::size_t>(hash_name(name.data(), name.size(), 0U, fold));
+		}
+
+		bool fold;
+	};
+
+	struct name_equal
+	{
+		explicit name_equal(const bool fold_case = false) : fold(fold_case) {}
+
+		// Stored names are folded and a folded name folds to itself, so only the query has to be folded.
+		// The standard doesn't tell which argument is the stored one: a word matches, if it's equal or
+		// folds to the other one.
+		inline const bool operator()(const std::string& a, const std::string& b) const
+		{
+			if (!fold || a.size() != b.size()) return a == b;
+
+			const std::size_t size = a.size();
+			std::size_t i = 0U;
+
+			for (; i + 8U <= size; i += 8U)
+			{
+				std::uint64_t x, y;
+				std::memcpy(&x, a.data() + i, 8U);
+				std::memcpy(&y, b.data() + i, 8U);
+				if (x != y && fold_word(x) != y && x != fold_word(y)) return false;
+			}
+
+			for (; i < size; ++i)
+			{
+				if (a[i] != b[i] && fold_char(a[i]) != b[i] && a[i] != fold_char(b[i])) return false;
+			}
+
+			return true;
+		}
+
+		bool fold;
+	};
+
+	enum ValueState
+	{
+		VALUE_PLAIN = 0x00,		// no references, value is used as is
+		VALUE_UNRESOLVED = 0x01,
+		VALUE_RESOLVING = 0x02,	// seen again while resolving means a cycle
+		VALUE_RESOLVED = 0x03,
+		VALUE_BROKEN = 0x04		// resolved with errors, which were reported once
+	};
+
+	struct blob_cache
+	{
+		std::vector<unsigned char> bytes;
+		bool decoded;						// false, if the text isn't base64 or hex
+	};
+
+	struct value_cache
+	{
+		value_cache() : parsed(nullptr), parsed_integer(0U), parsed_value(0.0) {}
+
+		std::string expanded;
+		const void* parsed;					// type_id() of the unit of the canonical value, or nullptr
+		std::uint64_t parsed_integer;		// canonical value of integral units
+		double parsed_value;				// canonical value of other units
+	};
+
+	struct value_data
+	{
+		value_data() : line(0U), file(0U), state(VALUE_PLAIN), blob(nullptr) {}
+
+		// Copies keep the expanded value, they are made for the same section of a parser copy. Blobs are decoded again.
+		value_data(const value_data& other) :
+			value(other.value), line(other.line), file(other.file), state(other.state),
+			cache(other.cache ? new value_cache(*other.cache) : nullptr), blob(nullptr)
+		{
+		}
+
+		~value_data()
+		{
+			delete blob.load(std::memory_order_acquire);
+		}
+
+		value_data& operator=(const value_data& other)
+		{
+			value = other.value;
+			line = other.line;
+			file = other.file;
+			state = other.state;
+			cache.reset(other.cache ? new value_cache(*other.cache) : nullptr);
+			this->drop_blob();
+			return *this;
+		}
+
+		void drop_blob() const
+		{
+			delete blob.exchange(nullptr, std::memory_order_acq_rel);
+		}
+
+		std::string value;
+		std::size_t line;
+		std::uint32_t file;					// index in _files
+		mutable std::uint8_t state;			// ValueState, changed only by non-const functions
+		mutable std::unique_ptr<value_cache> cache;
+		mutable std::atomic<const blob_cache*> blob; // published by the first getBlob()
+	};
+
+#ifdef CFG_TRACK_MEMORY
+	typedef CFGTrackingAllocator<std::pair<const std::string, value_data> > value_allocator;
+
+	static inline const value_allocator track(CFGAllocationCounter* counter)
+	{
+		return value_allocator(counter);
+	}
+#else
+	typedef std::allocator<std::pair<const std::string, value_data> > value_allocator;
+
+	static inline const value_allocator track(CFGAllocationCounter*)
+	{
+		return value_allocator();
+	}
+#endif
+
+	typedef std::unordered_map<std::string, value_data, name_hash, name_equal, value_allocator> value_map;
+
+	// Sections are shared between copies of a parser and copied before the first change,
+	// expanding a reference again is a change of its section too.
+	struct section_data
+	{
+		explicit section_data(const bool fold = false) :
+			allocated(), values(0U, name_hash(fold), name_equal(fold), track(&allocated)), references(false), content(0U)
+		{
+		}
+
+		// Order points into the values of other, copy_section() rebuilds it.
+		section_data(const section_data& other) :
+			allocated(), values(other.values, track(&allocated)), order(other.order), references(other.references), content(other.content)
+		{
+		}
+
+		section_data& operator=(const section_data&) = delete;
+
+		CFGAllocationCounter allocated; // buckets and nodes of values, counted with CFG_TRACK_MEMORY
+		value_map values;
+		std::vector<const value_map::value_type*> order; // keys in file order
+		bool references; // some value contains '$'
+		std::uint64_t content; // pair_hash of all keys and raw values
+	};
+
+	typedef std::shared_ptr<section_data> section_ptr;
+
+#ifdef CFG_TRACK_MEMORY
+	typedef CFGTrackingAllocator<std::pair<const std::string, section_ptr> > section_allocator;
+#else
+	typedef std::allocator<std::pair<const std::string, section_ptr> > section_allocator;
+#endif
+
+	typedef std::unordered_map<std::string, section_ptr, name_hash, name_equal, section_allocator> section_map;
+
+	// Folded section + '\0' + key of a value to the values, which reference it.
+	typedef std::unordered_map<std::string, std::vector<std::string> > dependency_map;
+
+	// Slots point to the values of the sections, four of them share a cache line.
+	struct frozen_slot
+	{
+		std::uint64_t fingerprint;
+		const value_data* data;
+	};
+
+	static_assert(sizeof(frozen_slot) == 16U, "frozen slot must be a quarter of a cache line");
+
+	struct frozen_table
+	{
+		std::uint64_t seed;
+		std::vector<std::uint64_t> displacement;
+		std::vector<frozen_slot> slots;
+		std::vector<section_ptr> sections; // keep the values alive for copies of the parser, which share the table
+	};
+
+	static inline const std::size_t frozen_position(const std::uint64_t hash, const std::uint64_t displacement, const std::size_t size)
+	{
+		return static_cast<std::size_t>(hash_mix(hash ^ displacement) % size);
+	}
+
+	static const bool place_hashes(const std::vector<std::uint64_t>& hashes, std::vector<std::uint64_t>& displacements, std::vector<std::size_t>& positions);
+
+	const value_data* find_value(const std::string& section, const std::string& key) const;
+
+	const value_data* find_frozen(const std::string& section, const std::string& key) const;
+
+	const value_data* find_frozen(const std::uint64_t hash) const;
+
+	static const bool convert(std::string_view str, bool& value);
+	static const bool convert(std::string_view str, char& value);
+	static const bool convert(std::string_view str, unsigned char& value);
+	static const bool convert(std::string_view str, short& value);
+	static const bool convert(std::string_view str, unsigned short& value);
+	static const bool convert(std::string_view str, int& value);
+	static const bool convert(std::string_view str, unsigned int& value);
+	static const bool convert(std::string_view str, long& value);
+	static const bool convert(std::string_view str, unsigned long& value);
+	static const bool convert(std::string_view str, long long& value);
+	static const bool convert(std::string_view str, unsigned long long& value);
+	static const bool convert(std::string_view str, float& value);
+	static const bool convert(std::string_view str, double& value);
+	static const bool convert(std::string_view str, long double& value);
+	static const bool convert(std::string_view str, Vec2& value);
+	static const bool convert(std::string_view str, Vec2i& value);
+	static const bool convert(std::string_view str, Vec2u& value);
+	static const bool convert(std::string_view str, Vec3& value);
+	static const bool convert(std::string_view str, Vec3i& value);
+	static const bool convert(std::string_view str, Vec3u& value);
+	static const bool convert(std::string_view str, Vec4& value);
+	static const bool convert(std::string_view str, Vec4i& value);
+	static const bool convert(std::string_view str, Vec4u& value);
+
+	static const bool convert_to(std::string_view str, const ValueType type, void* value);
+
+	template<typename T> static const bool convert_number(std::string_view str, T& value);
+
+	template<typename T> static const bool convert_components(std::string_view str, T* values, const std::size_t count);
+
+	static const bool convert_vector(std::string_view str, float* values, const std::size_t count);
+	static const bool convert_vector(std::string_view str, double* values, const std::size_t count);
+	static const bool convert_vector(std::string_view str, int* values, const std::size_t count);
+	static const bool convert_vector(std::string_view str, unsigned int* values, const std::size_t count);
+
+	template<typename T> static const bool convert(std::string_view str, T& value)
+	{
+		return convert_vector(str, vector_traits<T>::data(value), vector_traits<T>::size);
+	}
+
+	static const bool parse_unit(std::string_view str, const unit_suffix* suffixes, const std::size_t count, double& value);
+
+	static const bool parse_unit(std::string_view str, const unit_suffix* suffixes, const std::size_t count, std::uint64_t& value);
+
+	template<typename T> static const void* type_id()
+	{
+		static const char id = 0;
+		return &id;
+	}
+
+	template<typename U> static const bool parse_value(std::string_view str, typename unit_traits<U>::value_type& value)
+	{
+		typedef typename unit_traits<U>::value_type value_type;
+		const std::size_t count = sizeof(unit_traits<U>::suffixes) / sizeof(unit_suffix);
+
+		if constexpr (std::is_integral<value_type>::value)
+		{
+			// Whole numbers with whole factors stay exact, also above 2^53.
+			std::uint64_t integer;
+			if (parse_unit(str, unit_traits<U>::suffixes, count, integer))
+			{
+				if (integer > static_cast<std::uint64_t>(std::numeric_limits<value_type>::max())) return false;
+
+				value = static_cast<value_type>(integer);
+				return true;
+			}
+		}
+
+		double number;
+		if (!parse_unit(str, unit_traits<U>::suffixes, count, number)) return false;
+
+		if constexpr (std::is_integral<value_type>::value)
+		{
+			// The maximum rounds up in double, 2^digits is the exact bound.
+			number = std::round(number);
+			if (!(number >= static_cast<double>(std::numeric_limits<value_type>::min()) && number < std::ldexp(1.0, std::numeric_limits<value_type>::digits))) return false;
+
+			value = static_cast<value_type>(number);
+		}
+		else
+		{
+			value = static_cast<value_type>(number);
+		}
+
+		return true;
+	}
+
+	template<typename U> const bool unit_value(const value_data& data, const std::string& section, typename unit_traits<U>::value_type& value) const
+	{
+		typedef typename unit_traits<U>::value_type value_type;
+
+		// Values of schema keys are parsed when they're loaded, others on every read.
+		const value_cache* cache = data.cache.get();
+		if (cache && cache->parsed == type_id<U>())
+		{
+			if constexpr (std::is_integral<value_type>::value) value = static_cast<value_type>(cache->parsed_integer);
+			else value = static_cast<value_type>(cache->parsed_value);
+
+			return true;
+		}
+
+		return parse_value<U>(this->value_of(data, section), value);
+	}
+
+	template<typename U> void store_unit(const value_data& data, const std::string& section)
+	{
+		typedef typename unit_traits<U>::value_type value_type;
+
+		value_type value;
+		if (!parse_value<U>(this->value_of(data, section), value)) return;
+
+		if (!data.cache) data.cache.reset(new value_cache());
+		data.cache->parsed = type_id<U>();
+
+		if constexpr (std::is_integral<value_type>::value) data.cache->parsed_integer = static_cast<std::uint64_t>(value);
+		else data.cache->parsed_value = static_cast<double>(value);
+	}
+
+	void parse_units(const CFGSchema& schema);
+
+	void parse_units(const CFGSchema& schema, const std::size_t section, const std::string& name, const std::string& key, const value_data& data);
+
+	static const std::size_t string_bytes(const std::string& str);
+
+	template<typename M> static const std::size_t bucket_bytes(const M& map);
+
+	template<typename M> static const std::size_t node_bytes(const M& map);
+
+	const std::size_t section_bytes(const std::string& name, const section_data& sec, memory_data& memory) const;
+
+	const bool check_value(const CFGSchema::key_rule& rule, const value_data& data, const std::string& section, std::string& problem) const;
+
+	template<typename E> const bool enum_value(const value_data& data, const std::string& section, E& value) const
+	{
+		const std::size_t index = CFGEnum<E>::find(this->value_of(data, section));
+		if (index == CFGEnum<E>::npos) return false;
+
+		value = CFGEnum<E>::entry(index).value;
+		return true;
+	}
+
+	template<typename T> const std::size_t get_vectors(const std::string& section, const std::string* keys, const std::size_t count, const std::size_t size, T* const* components) const;
+
+	template<typename T> const T get_value(const std::string& section, const std::string& key, const T& default_value) const
+	{
+		const value_data* data = this->find_value(section, key);
+		if (data)
+		{
+			const std::string& str = this->value_of(*data, section);
+
+			T value;
+			if (convert(str, value))
+			{
+				return value;
+			}
+			else
+			{
+				std::cout << "Can't convert string \"" << str << "\" of section \"" << section << "\" key \"" << key << "\" to value! Return to default value..." << "\n}" << std::endl;
+				return default_value;
+			}
+		}
+		else
+		{
+			std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+			return default_value;
+		}
+	}
+
+	const std::string& value_of(const value_data& data, const std::string& section) const;
+
+	void resolve(const value_data& data, const std::string& section);
+
+	void expand_references();
+
+	void record_references(const value_data& data, const std::string& section, const std::string& key, const bool unique);
+
+	void prepare_values();
+
+	void update_values(const std::vector<std::string>& names);
+
+	const std::string set_override(const std::string& section, const std::string& key, const std::string& value);
+
+
+	void report(const value_data& data, const std::string& message);
+
+	void report(const std::uint32_t file, const std::size_t line, const std::string& message);
+
+	enum RecordType
+	{
+		RECORD_VALUE = 0x01,
+		RECORD_INHERIT = 0x02,
+		RECORD_INCLUDE = 0x03,
+		RECORD_DEFINE = 0x04,
+		RECORD_UNDEF = 0x05
+	};
+
+	struct file_data;
+
+	// Statement of a parsed file. Files are parsed into records once and replayed on every include.
+	struct record_data
+	{
+		RecordType type;
+		std::string section;
+		std::string name;		// key, inherited section, included file or symbol
+		std::string value;
+		std::size_t line;
+		std::shared_ptr<const file_data> include;
+	};
+
+	struct file_data
+	{
+		std::string path;
+		std::uint32_t index;	// in _files
+		bool conditional;		// records depend on symbols, directly or through includes
+		std::uint64_t symbols;	// _symbols_hash the records were made with
+		std::vector<record_data> records;
+	};
+
+	enum ConditionState
+	{
+		CONDITION_ACTIVE = 0x01,	// lines are parsed
+		CONDITION_SEARCHING = 0x02,	// no branch was taken yet, #elif and #else are checked
+		CONDITION_DONE = 0x03		// skipped till #endif
+	};
+
+	struct parse_state
+	{
+		std::string section, preprocess, inherit_name, key, value;
+		ProcessType ptype;
+		std::size_t line;
+		std::vector<std::uint8_t> conditions;
+		std::string* messages; // syntax messages are kept here instead of printed, if set
+	};
+
+	void begin_load();
+
+	const bool end_load();
+
+	void process_file(const std::string& cfg_file);
+
+	const std::shared_ptr<const file_data> load_file(const std::string& path);
+
+	void apply_file(const file_data& file);
+
+	void parse_buffer(const char* data, const std::size_t size, file_data& file);
+
+	void parse_lines(const char* pos, const char* end, parse_state& state, file_data& file);
+
+	const bool parse_parallel(const char* pos, const char* end, file_data& file);
+
+	static const std::size_t validate_utf8(const char* data, const std::size_t size);
+
+	static const bool decode_base64(std::string_view str, std::vector<unsigned char>& blob);
+
+	static const bool decode_hex(std::string_view str, std::vector<unsigned char>& blob);
+
+	void parse_line(std::string_view temp, parse_state& state, file_data& file);
+
+	static void parse_message(const parse_state& state, const std::string& message);
+
+	const bool parse_directive(std::string_view text, parse_state& state, file_data& file);
+
+	static const char* skip_block(const char* pos, const char* end, std::size_t& line);
+
+	void include_file(const std::string& name, const std::size_t line, file_data& file);
+
+	void prefetch_includes(const std::string& text, const std::string& path);
+
+	const bool evaluate(std::string_view condition) const;
+
+	void set_symbol(const std::string& name, const std::string& value);
+
+	void remove_symbol(const std::string& name);
+
+	void replay_symbols(const file_data& file);
+
+
+	void insert_value(const std::string& section, const std::string& key, const value_data& data);
+
+	void copy_order(const CFGParser& other);
+
+	section_data& writable_section(const section_map::iterator& it);
+
+	static const section_ptr copy_section(const section_data& section);
+
+	static void copy_sections(const section_map& from, section_map& to, const bool share);
+
+	const std::string fold_name(const std::string& name) const;
+
+	const std::vector<std::string_view> scan_names(const std::string& section, const std::string& pattern, const bool prefix) const;
+
+public:
+
+	/**
+		@brief One key of a section. Views point into the parser and live while it isn't changed.
+	*/
+	struct key_entry
+	{
+		std::string_view key;
+		std::string_view value; // as written, references aren't expanded
+		std::size_t line;
+	};
+
+	/**
+		@brief Iterator over the keys of a section in file order.
+	*/
+	class key_iterator
+	{
+	public:
+		explicit key_iterator(const value_map::value_type* const* it) : _it(it) {}
+
+		inline const key_entry operator*() const
+		{
+			return key_entry{ (*_it)->first, (*_it)->second.value, (*_it)->second.line };
+		}
+
+		inline key_iterator& operator++() { ++_it; return *this; }
+		inline const bool operator==(const key_iterator& other) const { return _it == other._it; }
+		inline const bool operator!=(const key_iterator& other) const { return _it != other._it; }
+
+	private:
+		const value_map::value_type* const* _it;
+	};
+
+	/**
+		@brief Range of the keys of a section, usable in range-based for.
+	*/
+	class key_range
+	{
+	public:
+		key_range() : _begin(nullptr), _end(nullptr) {}
+		key_range(const value_map::value_type* const* begin, const value_map::value_type* const* end) : _begin(begin), _end(end) {}
+
+		inline const key_iterator begin() const { return key_iterator(_begin); }
+		inline const key_iterator end() const { return key_iterator(_end); }
+		inline const std::size_t size() const { return static_cast<std::size_t>(_end - _begin); }
+		inline const bool empty() const { return _begin == _end; }
+
+	private:
+		const value_map::value_type* const* _begin;
+		const value_map::value_type* const* _end;
+	};
+
+	/**
+		@brief One section with its keys.
+	*/
+	struct section_entry
+	{
+		std::string_view name;
+		key_range keys;
+	};
+
+	/**
+		@brief Iterator over the sections in file order.
+	*/
+	class section_iterator
+	{
+	public:
+		explicit section_iterator(const section_map::value_type* const* it) : _it(it) {}
+
+		inline const section_entry operator*() const
+		{
+			const std::vector<const value_map::value_type*>& order = (*_it)->second->order;
+			return section_entry{ (*_it)->first, key_range(order.data(), order.data() + order.size()) };
+		}
+
+		inline section_iterator& operator++() { ++_it; return *this; }
+		inline const bool operator==(const section_iterator& other) const { return _it == other._it; }
+		inline const bool operator!=(const section_iterator& other) const { return _it != other._it; }
+
+	private:
+		const section_map::value_type* const* _it;
+	};
+
+	/**
+		@brief Range of the sections, usable in range-based for.
+	*/
+	class section_range
+	{
+	public:
+		section_range(const section_map::value_type* const* begin, const section_map::value_type* const* end) : _begin(begin), _end(end) {}
+
+		inline const section_iterator begin() const { return section_iterator(_begin); }
+		inline const section_iterator end() const { return section_iterator(_end); }
+		inline const std::size_t size() const { return static_cast<std::size_t>(_end - _begin); }
+		inline const bool empty() const { return _begin == _end; }
+
+	private:
+		const section_map::value_type* const* _begin;
+		const section_map::value_type* const* _end;
+	};
+
+	/**
+		@brief Return all sections in the order they appear in the files. Nothing is copied.
+
+		@code
+		for (const auto& section : cfg.sections())
+			for (const auto& entry : section.keys)
+				std::cout << section.name << "." << entry.key << " = " << entry.value << std::endl;
+		@endcode
+	*/
+	inline const section_range sections() const
+	{
+		return section_range(_order.data(), _order.data() + _order.size());
+	}
+
+	/**
+		@brief Return keys of the section in the order they appear in the files. Empty range, if section doesn't exist.
+	*/
+	const key_range keys(const std::string& section) const;
+
+	/**
+		@brief Lightweight handle of one section, returned by section().
+
+		The section is looked up once, every read is then a single key probe. In frozen
+		mode the hash of the section name is kept and only the key is hashed. A view
+		notices reloads, freeze() and override changes of its parser and looks the
+		section up again. The parser must outlive its views.
+
+		@code
+		const CFGParser::section_view physics = cfg.section("physics");
+		const float gravity = physics.getFloat("gravity", 9.81f);
+		const int steps = physics.getInt("steps", 4);
+		@endcode
+	*/
+	class section_view
+	{
+	public:
+		section_view() : _parser(nullptr), _values(nullptr), _overlay(nullptr), _seed(0U), _generation(0U) {}
+
+		/**
+			@brief Return name of the section.
+		*/
+		inline const std::string& getName() const { return _name; }
+
+		/**
+			@brief Short check, exist section or not.
+		*/
+		const bool exists() const;
+
+		/**
+			@brief Short check, exist key in section or not.
+		*/
+		inline const bool isKeyExist(const std::string& key) const { return (this->find(key) != nullptr) ? true : false; }
+
+		/**
+			@brief Typed getters, same as the getters of the parser.
+		*/
+		inline const bool getBool(const std::string& key, const bool& default_value = false) const { return this->get_value(key, default_value); }
+		inline const char getChar(const std::string& key, const char& default_value = 0) const { return this->get_value(key, default_value); }
+		inline const unsigned char getUChar(const std::string& key, const unsigned char& default_value = 0U) const { return this->get_value(key, default_value); }
+		inline const short getShort(const std::string& key, const short& default_value = 0) const { return this->get_value(key, default_value); }
+		inline const unsigned short getUShort(const std::string& key, const unsigned short& default_value = 0U) const { return this->get_value(key, default_value); }
+		inline const int getInt(const std::string& key, const int& default_value = 0) const { return this->get_value(key, default_value); }
+		inline const unsigned int getUInt(const std::string& key, const unsigned int& default_value = 0U) const { return this->get_value(key, default_value); }
+		inline const long getLong(const std::string& key, const long& default_value = 0L) const { return this->get_value(key, default_value); }
+		inline const unsigned long getULong(const std::string& key, const unsigned long& default_value = 0UL) const { return this->get_value(key, default_value); }
+		inline const long long getLLong(const std::string& key, const long long& default_value = 0LL) const { return this->get_value(key, default_value); }
+		inline const unsigned long long getULLong(const std::string& key, const unsigned long long& default_value = 0ULL) const { return this->get_value(key, default_value); }
+		inline const float getFloat(const std::string& key, const float& default_value = 0.0f) const { return this->get_value(key, default_value); }
+		inline const double getDouble(const std::string& key, const double& default_value = 0.0) const { return this->get_value(key, default_value); }
+		inline const long double getLDouble(const std::string& key, const long double& default_value = 0.0) const { return this->get_value(key, default_value); }
+		inline const Vec2 getVec2f(const std::string& key, const Vec2& default_value = Vec2(0.0f)) const { return this->get_value(key, default_value); }
+		inline const Vec2i getVec2i(const std::string& key, const Vec2i& default_value = Vec2i(0)) const { return this->get_value(key, default_value); }
+		inline const Vec2u getVec2u(const std::string& key, const Vec2u& default_value = Vec2u(0U)) const { return this->get_value(key, default_value); }
+		inline const Vec3 getVec3f(const std::string& key, const Vec3& default_value = Vec3(0.0f)) const { return this->get_value(key, default_value); }
+		inline const Vec3i getVec3i(const std::string& key, const Vec3i& default_value = Vec3i(0)) const { return this->get_value(key, default_value); }
+		inline const Vec3u getVec3u(const std::string& key, const Vec3u& default_value = Vec3u(0U)) const { return this->get_value(key, default_value); }
+		inline const Vec4 getVec4f(const std::string& key, const Vec4& default_value = Vec4(0.0f)) const { return this->get_value(key, default_value); }
+		inline const Vec4i getVec4i(const std::string& key, const Vec4i& default_value = Vec4i(0)) const { return this->get_value(key, default_value); }
+		inline const Vec4u getVec4u(const std::string& key, const Vec4u& default_value = Vec4u(0U)) const { return this->get_value(key, default_value); }
+		template<typename T> const T getVector(const std::string& key, const T& default_value = T()) const { return this->get_value(key, default_value); }
+		inline const std::uint64_t getSize(const std::string& key, const std::uint64_t default_value = 0U) const { return this->getUnit<unit_size>(key, default_value); }
+		inline const double getDuration(const std::string& key, const double default_value = 0.0) const { return this->getUnit<unit_duration>(key, default_value); }
+		inline const double getPercent(const std::string& key, const double default_value = 0.0) const { return this->getUnit<unit_percent>(key, default_value); }
+
+		template<typename E> const E getEnum(const std::string& key, const E default_value = E()) const
+		{
+			const value_data* data = this->find(key);
+			if (!data)
+			{
+				std::cout << "Section \"" << _name << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+				return default_value;
+			}
+
+			E value;
+			if (_parser->enum_value(*data, _name, value)) return value;
+
+			std::cout << "Unknown name \"" << _parser->value_of(*data, _name) << "\" of section \"" << _name << "\" key \"" << key << "\"! Return to default value..." << "\n}" << std::endl;
+			return default_value;
+		}
+
+		template<typename U> const typename unit_traits<U>::value_type getUnit(const std::string& key, const typename unit_traits<U>::value_type& default_value = 0) const
+		{
+			const value_data* data = this->find(key);
+			if (!data)
+			{
+				std::cout << "Section \"" << _name << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+				return default_value;
+			}
+
+			typename unit_traits<U>::value_type value;
+			if (_parser->unit_value<U>(*data, _name, value)) return value;
+
+			std::cout << "Can't convert string \"" << _parser->value_of(*data, _name) << "\" of section \"" << _name << "\" key \"" << key << "\" to value! Return to default value..." << "\n}" << std::endl;
+			return default_value;
+		}
+
+		/**
+			@brief Return string value. Otherwise return default value.
+		*/
+		const std::string& getString(const std::string& key, const std::string& default_value = "empty_string") const;
+
+	private:
+		friend class CFGParser;
+
+		section_view(const CFGParser* parser, const std::string& name) : _parser(parser), _name(name), _values(nullptr), _overlay(nullptr), _seed(0U), _generation(0U)
+		{
+			this->refresh();
+		}
+
+		const value_data* find(const std::string& key) const;
+
+		void refresh() const;
+
+		template<typename T> const T get_value(const std::string& key, const T& default_value) const
+		{
+			const value_data* data = this->find(key);
+			if (data)
+			{
+				const std::string& str = _parser->value_of(*data, _name);
+
+				T value;
+				if (convert(str, value))
+				{
+					return value;
+				}
+				else
+				{
+					std::cout << "Can't convert string \"" << str << "\" of section \"" << _name << "\" key \"" << key << "\" to value! Return to default value..." << "\n}" << std::endl;
+					return default_value;
+				}
+			}
+			else
+			{
+				std::cout << "Section \"" << _name << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+				return default_value;
+			}
+		}
+
+		const CFGParser* _parser;
+		std::string _name;
+		mutable const section_data* _values;
+		mutable const section_data* _overlay;
+		mutable std::uint64_t _seed;			// frozen mode, hash of the section name
+		mutable std::uint64_t _generation;
+	};
+
+	/**
+		@brief Return view of the section. The view of a missing section finds nothing.
+	*/
+	inline const section_view section(const std::string& name) const
+	{
+		return section_view(this, name);
+	}
+
+	/**
+		@brief Return number, which changes whenever lookups can give other results(load, freeze, overrides).
+	*/
+	inline const std::uint64_t getGeneration() const
+	{
+		return _generation;
+	}
 
 private:
+	CFGAllocationCounter _allocated; // buckets and nodes of the section maps, counted with CFG_TRACK_MEMORY
 	section_map _buffer;
+	std::vector<const section_map::value_type*> _order;
+	std::shared_ptr<const frozen_table> _frozen;
+	section_map _overlay;
+	std::shared_ptr<dependency_map> _dependents; // shared by the copies, copied before the first change
+	CFGRadixTree _section_index;
+	CFGRadixTree _key_index; // paths are section + '\0' + key
 	std::string _cfg_base_path;
-	ProcessType _ptype;
-	std::size_t _line;
+	unsigned int _options;
+	CFGIncludeManager _includes;
+	CFGFileReader _reader;
+	std::unordered_map<std::string, std::shared_ptr<const file_data> > _file_cache; // by canonical path, during load only
+	std::vector<std::string> _files;
+	std::unordered_map<std::string, std::string> _defines;
+	std::unordered_map<std::string, std::string> _symbols; // _defines with symbols of the files, during load only
+	std::uint64_t _symbols_hash; // order-independent hash of _symbols
+	std::uint64_t _generation;
+	std::vector<error_data> _errors;
+	const CFGSchema* _schema;
 
 };
 
@@ -0,0 +1,188 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGPushParser.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+CFGPushParser::CFGPushParser(CFGParser& parser, const std::string& source_name) :
+	_parser(parser),
+	_staging(parser._options),
+	_name(source_name),
+	_started(false),
+	_bom_checked(false),
+	_failed(false),
+	_finished(false)
+{
+	_state.ptype = CFGParser::KEY;
+	_state.line = 0U;
+	_state.messages = nullptr;
+}
+
+
+CFGPushParser::~CFGPushParser()
+{
+}
+
+
+const bool CFGPushParser::feed(const char* data, const std::size_t size)
+{
+	if (_finished)
+	{
+		std::cout << "Push parser of \"" << _name << "\" is already finished!" << "\n}" << std::endl;
+		return false;
+	}
+
+	if (!_started) this->start();
+	if (_failed) return false;
+
+	const char* pos = data;
+	const char* end = data + size;
+
+	// UTF-8 byte order mark, its bytes may come in different chunks.
+	if (!_bom_checked)
+	{
+		const std::size_t count = std::min(static_cast<std::size_t>(3U) - _pending.size(), size);
+		_pending.append(pos, count);
+		pos += count;
+
+		if (_pending.size() < 3U) return true;
+
+		if (_pending == "\xEF\xBB\xBF") _pending.clear();
+		_bom_checked = true;
+	}
+
+	// The unfinished line is completed by the first line end of the chunk.
+	if (!_pending.empty())
+	{
+		const char* nl = static_cast<const char*>(std::memchr(pos, '\n', static_cast<std::size_t>(end - pos)));
+		if (!nl)
+		{
+			_pending.append(pos, static_cast<std::size_t>(end - pos));
+			return true;
+		}
+
+		_pending.append(pos, static_cast<std::size_t>(nl + 1 - pos));
+		pos = nl + 1;
+
+		this->consume(_pending.data(), _pending.size());
+		_pending.clear();
+	}
+
+	// Complete lines are parsed in place, only the rest is kept.
+	const char* last = end;
+	while (last > pos && last[-1] != '\n') last--;
+
+	if (last > pos) this->consume(pos, static_cast<std::size_t>(last - pos));
+	_pending.assign(last, static_cast<std::size_t>(end - last));
+
+	return !_failed;
+}
+
+
+const bool CFGPushParser::finish()
+{
+	if (_finished) return false;
+
+	if (!_started) this->start();
+
+	if (!_bom_checked && _pending == "\xEF\xBB\xBF") _pending.clear();
+	_bom_checked = true;
+
+	if (!_pending.empty())
+	{
+		this->consume(_pending.data(), _pending.size());
+		_pending.clear();
+	}
+
+	if (!_failed && !_state.conditions.empty()) _staging.report(_file->index, _state.line, "Unterminated #if block!");
+	_staging.end_load();
+
+	// The target is loaded in one go, with the files and problems of the stream.
+	_parser.begin_load();
+	_parser._files = _staging._files;
+	_parser._errors = _staging._errors;
+	if (!_failed) _parser.apply_file(*_file);
+
+	_finished = true;
+	_file.reset();
+
+	return _parser.end_load();
+}
+
+
+const std::size_t CFGPushParser::getLineNum() const
+{
+	return _state.line;
+}
+
+
+const std::size_t CFGPushParser::getPendingSize() const
+{
+	return _pending.size();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+void CFGPushParser::start()
+{
+	_staging._cfg_base_path = _parser._cfg_base_path;
+	_staging._includes = _parser._includes;
+	_staging._defines = _parser._defines;
+	_staging.begin_load();
+
+	_file = std::make_shared<CFGParser::file_data>();
+	_file->path = _name;
+	_file->conditional = false;
+	_file->symbols = _staging._symbols_hash;
+	_file->index = static_cast<std::uint32_t>(_staging._files.size());
+	_staging._files.push_back(_name);
+
+	_started = true;
+}
+
+
+void CFGPushParser::consume(const char* data, const std::size_t size)
+{
+	if (_failed) return;
+
+	// Lines never split a UTF-8 sequence, so complete lines can be checked on their own.
+	if ((_staging._options & CFGParser::VALIDATE_UTF8) != 0U)
+	{
+		const std::size_t invalid = CFGParser::validate_utf8(data, size);
+		if (invalid != size)
+		{
+			const char* start = data + invalid;
+			while (start > data && start[-1] != '\n') start--;
+
+			const std::size_t line = _state.line + static_cast<std::size_t>(std::count(data, start, '\n')) + 1U;
+			_staging.report(_file->index, line, "Invalid UTF-8 at byte " + std::to_string(data + invalid - start) + " of the line, stream is skipped!");
+			_failed = true;
+			return;
+		}
+	}
+
+	_staging.parse_lines(data, data + size, _state, *_file);
+}
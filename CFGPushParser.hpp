@@ -0,0 +1,121 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_PUSH_PARSER_HPP_
+#define _CFG_PUSH_PARSER_HPP_
+
+#include "CFGParser.hpp"
+
+
+/**
+	@brief Parses a config which arrives in chunks of any size, for pipes and sockets.
+
+	Every complete line of a chunk is tokenized right away, with the same state
+	machine as files. Only the unfinished last line is kept until the next chunk,
+	so no byte is scanned twice and the whole payload is never buffered.
+
+	The stream is parsed into a private parser, which takes the base path, include
+	paths and defines of the target at the first feed(). The target isn't touched
+	until finish(), so it can be read while the stream arrives. finish() replaces
+	its config like load() does, overrides and defines are kept, checks the schema
+	and returns like load(). A push parser destroyed before finish() drops the
+	stream and leaves the target as it was.
+
+	@code
+	CFGParser cfg;
+	CFGPushParser push(cfg, "socket");
+
+	char chunk[4096];
+	ssize_t size;
+	while ((size = read(fd, chunk, sizeof(chunk))) > 0) push.feed(chunk, static_cast<std::size_t>(size));
+
+	push.finish();
+	@endcode
+*/
+class CFGPushParser
+{
+public:
+
+	/**
+		@brief Constructor.
+		@param Parser, which is filled by finish().
+		@param Source name for getErrors() and relative includes.
+	*/
+	CFGPushParser(CFGParser& parser, const std::string& source_name = "stream");
+
+	/**
+		@brief Destructor. An unfinished parse is dropped, the target isn't changed.
+	*/
+	virtual ~CFGPushParser();
+
+	CFGPushParser(const CFGPushParser&) = delete;
+	CFGPushParser& operator=(const CFGPushParser&) = delete;
+
+	/**
+		@brief Parse next chunk. Return false after invalid UTF-8(with CFGParser::VALIDATE_UTF8) or after finish().
+	*/
+	const bool feed(const char* data, const std::size_t size);
+
+	/**
+		@brief Parse the last line and replace the config of the parser with the values. Return like CFGParser::load().
+	*/
+	const bool finish();
+
+	/**
+		@brief Return number of parsed lines.
+	*/
+	const std::size_t getLineNum() const;
+
+	/**
+		@brief Return number of bytes kept for an unfinished line.
+	*/
+	const std::size_t getPendingSize() const;
+
+	/**
+		@brief Return true, if finish() was called.
+	*/
+	inline const bool isFinished() const
+	{
+		return _finished;
+	}
+
+protected:
+
+	void start();
+
+	void consume(const char* data, const std::size_t size);
+
+private:
+	CFGParser& _parser;
+	CFGParser _staging; // parses the stream, the target is changed only by finish()
+	std::string _name;
+	std::shared_ptr<CFGParser::file_data> _file;
+	CFGParser::parse_state _state;
+	std::string _pending; // bytes after the last line end
+	bool _started;
+	bool _bom_checked;
+	bool _failed;
+	bool _finished;
+
+};
+
+#endif
@@ -0,0 +1,262 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGRadixTree.hpp"
+#include <algorithm>
+#include <functional>
+
+
+CFGRadixTree::CFGRadixTree() :
+	_size(0U)
+{
+}
+
+
+CFGRadixTree::~CFGRadixTree()
+{
+	this->clear();
+}
+
+
+void CFGRadixTree::insert(std::string_view path, std::string_view value)
+{
+	node* current = &_root;
+
+	while (!path.empty())
+	{
+		std::vector<std::unique_ptr<node> >& children = current->children;
+		std::vector<std::unique_ptr<node> >::iterator it = std::lower_bound(children.begin(), children.end(), path[0], [](const std::unique_ptr<node>& child, const char chr)
+		{
+			return child->label[0] < chr;
+		});
+
+		if (it == children.end() || (*it)->label[0] != path[0])
+		{
+			std::unique_ptr<node> leaf(new node());
+			leaf->label.assign(path.data(), path.size());
+			leaf->value = value;
+			leaf->terminal = true;
+			children.insert(it, std::move(leaf));
+			_size++;
+			return;
+		}
+
+		const std::string& label = (*it)->label;
+		std::size_t common = 0U;
+		while (common < label.size() && common < path.size() && label[common] == path[common]) common++;
+
+		if (common < label.size())
+		{
+			// Split the child: the common part becomes a new node above it.
+			std::unique_ptr<node> middle(new node());
+			middle->label = label.substr(0U, common);
+			(*it)->label.erase(0U, common);
+			middle->children.push_back(std::move(*it));
+			*it = std::move(middle);
+		}
+
+		current = (*it).get();
+		path.remove_prefix(common);
+	}
+
+	if (!current->terminal) _size++;
+	current->terminal = true;
+	current->value = value;
+}
+
+
+void CFGRadixTree::clear()
+{
+	_root.children.clear();
+	_root.terminal = false;
+	_size = 0U;
+}
+
+
+const std::size_t CFGRadixTree::size() const
+{
+	return _size;
+}
+
+
+const std::size_t CFGRadixTree::getMemoryUsage() const
+{
+	return this->node_bytes(_root) - sizeof(node);
+}
+
+
+void CFGRadixTree::findPrefix(std::string_view scope, std::string_view prefix, std::vector<std::string_view>& result) const
+{
+	const node* current = &_root;
+	std::size_t pos = 0U;
+
+	if (this->descend(scope, current, pos) && this->descend(prefix, current, pos))
+	{
+		this->collect(*current, result);
+	}
+}
+
+
+void CFGRadixTree::findGlob(std::string_view scope, std::string_view pattern, std::vector<std::string_view>& result) const
+{
+	const std::size_t literal = std::min(pattern.find_first_of("*?"), pattern.size());
+	const node* current = &_root;
+	std::size_t pos = 0U;
+
+	if (!this->descend(scope, current, pos) || !this->descend(pattern.substr(0U, literal), current, pos)) return;
+
+	// A pattern with several stars can reach one path in different ways.
+	std::vector<const node*> nodes;
+	this->glob(*current, pos, pattern.substr(literal), nodes);
+
+	std::sort(nodes.begin(), nodes.end());
+	nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+	std::sort(nodes.begin(), nodes.end(), [](const node* a, const node* b)
+	{
+		return a->value < b->value;
+	});
+
+	for (const node* found : nodes) result.push_back(found->value);
+}
+
+
+const bool CFGRadixTree::match(std::string_view pattern, std::string_view text)
+{
+	std::size_t p = 0U, t = 0U;
+	std::size_t star = std::string_view::npos, resume = 0U;
+
+	while (t < text.size())
+	{
+		if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t]))
+		{
+			p++;
+			t++;
+		}
+		else if (p < pattern.size() && pattern[p] == '*')
+		{
+			star = p++;
+			resume = t;
+		}
+		else if (star != std::string_view::npos)
+		{
+			p = star + 1U;
+			t = ++resume;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while (p < pattern.size() && pattern[p] == '*') p++;
+
+	return p == pattern.size();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+const CFGRadixTree::node* CFGRadixTree::find_child(const node& parent, const char chr) const
+{
+	const std::vector<std::unique_ptr<node> >& children = parent.children;
+	std::vector<std::unique_ptr<node> >::const_iterator it = std::lower_bound(children.begin(), children.end(), chr, [](const std::unique_ptr<node>& child, const char value)
+	{
+		return child->label[0] < value;
+	});
+
+	return (it != children.end() && (*it)->label[0] == chr) ? (*it).get() : nullptr;
+}
+
+
+const bool CFGRadixTree::descend(std::string_view path, const node*& current, std::size_t& pos) const
+{
+	while (!path.empty())
+	{
+		if (pos == current->label.size())
+		{
+			current = this->find_child(*current, path[0]);
+			pos = 0U;
+			if (!current) return false;
+		}
+
+		const std::size_t count = std::min(current->label.size() - pos, path.size());
+		if (current->label.compare(pos, count, path.data(), count) != 0) return false;
+
+		pos += count;
+		path.remove_prefix(count);
+	}
+
+	return true;
+}
+
+
+void CFGRadixTree::collect(const node& current, std::vector<std::string_view>& result) const
+{
+	if (current.terminal) result.push_back(current.value);
+
+	for (const std::unique_ptr<node>& child : current.children) this->collect(*child, result);
+}
+
+
+const std::size_t CFGRadixTree::node_bytes(const node& current) const
+{
+	std::size_t bytes = sizeof(node) + current.children.capacity() * sizeof(std::unique_ptr<node>);
+
+	// Short labels live inside the string object.
+	const char* object = reinterpret_cast<const char*>(&current.label);
+	if (std::less<const char*>()(current.label.data(), object) || !std::less<const char*>()(current.label.data(), object + sizeof(std::string))) bytes += current.label.capacity() + 1U;
+
+	for (const std::unique_ptr<node>& child : current.children) bytes += this->node_bytes(*child);
+
+	return bytes;
+}
+
+
+void CFGRadixTree::glob(const node& current, const std::size_t pos, std::string_view pattern, std::vector<const node*>& result) const
+{
+	if (pos == current.label.size())
+	{
+		if (current.terminal && pattern.find_first_not_of('*') == std::string_view::npos) result.push_back(&current);
+
+		if (pattern.empty()) return;
+
+		for (const std::unique_ptr<node>& child : current.children) this->glob(*child, 0U, pattern, result);
+		return;
+	}
+
+	if (pattern.empty()) return;
+
+	const char chr = pattern[0];
+	if (chr == '*')
+	{
+		std::size_t stars = 1U;
+		while (stars < pattern.size() && pattern[stars] == '*') stars++;
+
+		this->glob(current, pos, pattern.substr(stars), result);
+		this->glob(current, pos + 1U, pattern, result);
+	}
+	else if (chr == '?' || chr == current.label[pos])
+	{
+		this->glob(current, pos + 1U, pattern.substr(1U), result);
+	}
+}
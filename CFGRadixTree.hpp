@@ -0,0 +1,119 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_RADIX_TREE_HPP_
+#define _CFG_RADIX_TREE_HPP_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+
+/**
+	@brief Compressed prefix tree over names, used for prefix and wildcard queries.
+
+	Every stored path carries a view, which is returned by the queries. The tree
+	doesn't own the viewed strings. Results come in lexicographic order of paths.
+
+	Wildcard patterns support '*'(any sequence, also empty) and '?'(any single character).
+	The literal part of a pattern before the first wildcard is walked directly, so
+	a query only visits the subtree which can match.
+*/
+class CFGRadixTree
+{
+public:
+
+	/**
+		@brief Constructor.
+	*/
+	CFGRadixTree();
+
+	/**
+		@brief Destructor.
+	*/
+	virtual ~CFGRadixTree();
+
+	/**
+		@brief Add path with its view. View of an existing path is replaced.
+	*/
+	void insert(std::string_view path, std::string_view value);
+
+	/**
+		@brief Remove all paths.
+	*/
+	void clear();
+
+	/**
+		@brief Return number of stored paths.
+	*/
+	const std::size_t size() const;
+
+	/**
+		@brief Return approximate number of bytes held by the nodes and their labels.
+	*/
+	const std::size_t getMemoryUsage() const;
+
+	/**
+		@brief Append views of all paths which start with scope + prefix.
+	*/
+	void findPrefix(std::string_view scope, std::string_view prefix, std::vector<std::string_view>& result) const;
+
+	/**
+		@brief Append views of all paths which are scope followed by text matching the pattern.
+	*/
+	void findGlob(std::string_view scope, std::string_view pattern, std::vector<std::string_view>& result) const;
+
+	/**
+		@brief Check single text against a wildcard pattern, without the tree.
+	*/
+	static const bool match(std::string_view pattern, std::string_view text);
+
+protected:
+
+	struct node
+	{
+		node() : terminal(false) {}
+
+		std::string label;
+		std::vector<std::unique_ptr<node> > children; // sorted by the first character of label
+		std::string_view value;
+		bool terminal;
+	};
+
+	const node* find_child(const node& parent, const char chr) const;
+
+	const bool descend(std::string_view path, const node*& current, std::size_t& pos) const;
+
+	void collect(const node& current, std::vector<std::string_view>& result) const;
+
+	const std::size_t node_bytes(const node& current) const;
+
+	void glob(const node& current, const std::size_t pos, std::string_view pattern, std::vector<const node*>& result) const;
+
+private:
+	node _root;
+	std::size_t _size;
+
+};
+
+#endif
@@ -0,0 +1,311 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGReader.hpp"
+#include <fstream>
+#include <algorithm>
+
+#ifdef USE_IO_URING
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/stat.h>
+#endif
+
+
+#ifdef USE_IO_URING
+
+CFGFileReader::CFGFileReader() :
+	_ring_ready(false)
+{
+}
+
+
+CFGFileReader::~CFGFileReader()
+{
+	this->clear();
+}
+
+
+void CFGFileReader::request(const std::string& path)
+{
+	if (_pending.find(path) != _pending.end()) return;
+
+	// The ring lives from the first request of a load till clear().
+	if (!_ring_ready) _ring_ready = (io_uring_queue_init(64U, &_ring, 0U) == 0);
+	if (!_ring_ready) return;
+
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return;
+
+	struct stat info;
+	if (::fstat(fd, &info) != 0)
+	{
+		::close(fd);
+		return;
+	}
+
+	std::unique_ptr<pending_read> pending(new pending_read());
+	pending->fd = fd;
+	pending->text.resize(static_cast<std::size_t>(info.st_size));
+	pending->done = 0U;
+	pending->finished = pending->text.empty();
+	pending->failed = false;
+
+	if (!pending->finished) this->submit(*pending);
+
+	_pending.emplace(path, std::move(pending));
+}
+
+
+const bool CFGFileReader::take(const std::string& path, std::string& text)
+{
+	const std::unordered_map<std::string, std::unique_ptr<pending_read> >::iterator it = _pending.find(path);
+	if (it == _pending.end()) return read(path, text);
+
+	pending_read& pending = *(*it).second;
+	while (!pending.finished) this->wait_one();
+
+	::close(pending.fd);
+	const bool failed = pending.failed;
+	if (!failed) text.swap(pending.text);
+	_pending.erase(it);
+
+	return failed ? read(path, text) : true;
+}
+
+
+void CFGFileReader::clear()
+{
+	for (std::pair<const std::string, std::unique_ptr<pending_read> >& pending : _pending)
+	{
+		// The kernel may still write into the buffer.
+		while (!pending.second->finished) this->wait_one();
+		::close(pending.second->fd);
+	}
+
+	_pending.clear();
+
+	if (_ring_ready)
+	{
+		io_uring_queue_exit(&_ring);
+		_ring_ready = false;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+void CFGFileReader::submit(pending_read& pending)
+{
+	io_uring_sqe* sqe = io_uring_get_sqe(&_ring);
+	if (!sqe)
+	{
+		io_uring_submit(&_ring);
+		sqe = io_uring_get_sqe(&_ring);
+	}
+
+	if (!sqe)
+	{
+		pending.finished = true;
+		pending.failed = true;
+		return;
+	}
+
+	io_uring_prep_read(sqe, pending.fd, &pending.text[pending.done], static_cast<unsigned int>(pending.text.size() - pending.done), static_cast<__u64>(pending.done));
+	io_uring_sqe_set_data(sqe, &pending);
+	io_uring_submit(&_ring);
+}
+
+
+void CFGFileReader::wait_one()
+{
+	io_uring_cqe* cqe = nullptr;
+	if (io_uring_wait_cqe(&_ring, &cqe) != 0 || !cqe)
+	{
+		// Ring is broken, whatever is left is read the blocking way.
+		for (std::pair<const std::string, std::unique_ptr<pending_read> >& pending : _pending)
+		{
+			pending.second->finished = true;
+			pending.second->failed = true;
+		}
+		return;
+	}
+
+	pending_read& pending = *static_cast<pending_read*>(io_uring_cqe_get_data(cqe));
+	const int result = cqe->res;
+	io_uring_cqe_seen(&_ring, cqe);
+
+	if (result < 0)
+	{
+		pending.finished = true;
+		pending.failed = true;
+	}
+	else if (result == 0)
+	{
+		// File got shorter since it was opened.
+		pending.text.resize(pending.done);
+		pending.finished = true;
+	}
+	else
+	{
+		pending.done += static_cast<std::size_t>(result);
+		if (pending.done < pending.text.size()) this->submit(pending);
+		else
+		{
+			pending.finished = true;
+		}
+	}
+}
+
+#else
+
+CFGFileReader::CFGFileReader() :
+	_idle(0U),
+	_stopping(false)
+{
+}
+
+
+CFGFileReader::~CFGFileReader()
+{
+	this->clear();
+}
+
+
+void CFGFileReader::request(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_pending.find(path) != _pending.end()) return;
+
+	std::unique_ptr<pending_read> pending(new pending_read());
+	pending->path = path;
+	pending->started = false;
+	pending->finished = false;
+	pending->ok = false;
+
+	_queue.push_back(pending.get());
+	_pending.emplace(path, std::move(pending));
+
+	// A new thread is started only while the waiting ones can't take all queued files.
+	if (_queue.size() > _idle && _threads.size() < MAX_THREADS) _threads.emplace_back(&CFGFileReader::work, this);
+	else _queued.notify_one();
+}
+
+
+const bool CFGFileReader::take(const std::string& path, std::string& text)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	const std::unordered_map<std::string, std::unique_ptr<pending_read> >::iterator it = _pending.find(path);
+	if (it == _pending.end())
+	{
+		lock.unlock();
+		return read(path, text);
+	}
+
+	pending_read& pending = *(*it).second;
+	if (!pending.started)
+	{
+		// Still queued behind other files, reading it here is quicker than waiting.
+		_queue.erase(std::find(_queue.begin(), _queue.end(), &pending));
+		_pending.erase(it);
+		lock.unlock();
+		return read(path, text);
+	}
+
+	_finished.wait(lock, [&pending]() { return pending.finished; });
+
+	const bool ok = pending.ok;
+	text.swap(pending.text);
+	_pending.erase(it);
+
+	return ok;
+}
+
+
+void CFGFileReader::clear()
+{
+	std::vector<std::thread> threads;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_queue.clear();
+		_stopping = true;
+		threads.swap(_threads);
+	}
+
+	// Threads end after their current read.
+	_queued.notify_all();
+	for (std::thread& thread : threads) thread.join();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_stopping = false;
+	_pending.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+void CFGFileReader::work()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	for (;;)
+	{
+		_idle++;
+		_queued.wait(lock, [this]() { return _stopping || !_queue.empty(); });
+		_idle--;
+
+		if (_stopping) break;
+
+		pending_read& pending = *_queue.front();
+		_queue.pop_front();
+		pending.started = true;
+
+		lock.unlock();
+		std::string text;
+		const bool ok = read(pending.path, text);
+		lock.lock();
+
+		pending.text.swap(text);
+		pending.ok = ok;
+		pending.finished = true;
+		_finished.notify_all();
+	}
+}
+
+#endif
+
+
+const bool CFGFileReader::read(const std::string& path, std::string& text)
+{
+	std::ifstream stream(path, std::ios::in | std::ios::binary);
+	if (!stream.good()) return false;
+
+	stream.seekg(0, std::ios::end);
+	text.resize(static_cast<std::size_t>(stream.tellg()));
+	stream.seekg(0, std::ios::beg);
+	if (!text.empty()) stream.read(&text[0], static_cast<std::streamsize>(text.size()));
+
+	return !stream.fail();
+}
@@ -0,0 +1,139 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_READER_HPP_
+#define _CFG_READER_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <memory>
+
+#ifdef USE_IO_URING
+  #include <liburing.h>
+#else
+  #include <vector>
+  #include <deque>
+  #include <thread>
+  #include <mutex>
+  #include <condition_variable>
+#endif
+
+
+/**
+	@brief Reads whole files, optionally ahead of time.
+
+	request() starts reading a file in the background, take() waits for it and hands
+	the text over. Files which weren't requested are read on the spot. The parser
+	requests includes as soon as it sees them, so slow reads overlap with tokenizing.
+
+	With USE_IO_URING defined(link with -luring) reads are submitted to an io_uring,
+	which is set up by the first request and closed by clear(), so idle readers hold
+	no ring. Otherwise requests are read by at most MAX_THREADS threads, which are
+	started by the first requests and wait for more until clear().
+*/
+class CFGFileReader
+{
+public:
+
+	/**
+		@brief Constructor.
+	*/
+	CFGFileReader();
+
+	/**
+		@brief Destructor. Waits for the reads in flight.
+	*/
+	virtual ~CFGFileReader();
+
+	CFGFileReader(const CFGFileReader&) = delete;
+	CFGFileReader& operator=(const CFGFileReader&) = delete;
+
+	/**
+		@brief Start reading the file in the background. Repeated requests are ignored.
+	*/
+	void request(const std::string& path);
+
+	/**
+		@brief Return text of the file, waiting for its read if it was requested. Return false, if file can't be read.
+	*/
+	const bool take(const std::string& path, std::string& text);
+
+	/**
+		@brief Wait for the reads in flight and drop texts which weren't taken.
+	*/
+	void clear();
+
+	/**
+		@brief Blocking read of the whole file.
+	*/
+	static const bool read(const std::string& path, std::string& text);
+
+protected:
+
+#ifdef USE_IO_URING
+	struct pending_read
+	{
+		int fd;
+		std::string text;
+		std::size_t done;	// bytes read so far
+		bool finished;
+		bool failed;
+	};
+
+	void submit(pending_read& pending);
+
+	void wait_one();
+
+#else
+	static const std::size_t MAX_THREADS = 4U;
+
+	struct pending_read
+	{
+		std::string path;
+		std::string text;
+		bool started;
+		bool finished;
+		bool ok;
+	};
+
+	void work();
+#endif
+
+private:
+#ifdef USE_IO_URING
+	io_uring _ring;
+	bool _ring_ready;
+	std::unordered_map<std::string, std::unique_ptr<pending_read> > _pending;
+#else
+	std::unordered_map<std::string, std::unique_ptr<pending_read> > _pending;
+	std::deque<pending_read*> _queue;
+	std::vector<std::thread> _threads;
+	std::size_t _idle;		// threads waiting for a request
+	bool _stopping;			// set by clear(), threads end
+	std::mutex _mutex;
+	std::condition_variable _queued;
+	std::condition_variable _finished;
+#endif
+
+};
+
+#endif
@@ -0,0 +1,183 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGSchema.hpp"
+#include "CFGRadixTree.hpp"
+
+
+CFGSchema::CFGSchema(const bool case_insensitive) :
+	_case_insensitive(case_insensitive)
+{
+}
+
+
+CFGSchema::~CFGSchema()
+{
+	_sections.clear();
+	_keys.clear();
+}
+
+
+void CFGSchema::addSection(const std::string& section, const bool required, const bool closed)
+{
+	const std::string name = this->fold(section);
+	const bool pattern = (name.find_first_of("*?") != std::string::npos);
+
+	std::unordered_map<std::string, std::size_t>::const_iterator it = _section_index.find(name);
+	if (it == _section_index.end())
+	{
+		section_rule rule;
+		rule.name = section;
+		rule.pattern = pattern;
+
+		it = _section_index.emplace(name, _sections.size()).first;
+		if (pattern) _patterns.push_back(_sections.size());
+		_sections.push_back(rule);
+	}
+
+	section_rule& rule = _sections[(*it).second];
+	rule.required = required && !pattern;
+	rule.closed = closed;
+}
+
+
+void CFGSchema::addKey(const std::string& section, const std::string& key, const KeyType type, const bool required)
+{
+	std::unordered_map<std::string, std::size_t>::const_iterator it = _section_index.find(this->fold(section));
+	if (it == _section_index.end())
+	{
+		this->addSection(section);
+		it = _section_index.find(this->fold(section));
+	}
+
+	section_rule& sec = _sections[(*it).second];
+	const std::pair<std::unordered_map<std::string, std::size_t>::iterator, bool> result = sec.keys.emplace(this->fold(key), _keys.size());
+
+	if (result.second)
+	{
+		key_rule rule;
+		rule.name = key;
+		rule.ranged = false;
+		rule.min = 0.0;
+		rule.max = 0.0;
+		_keys.push_back(rule);
+	}
+
+	key_rule& rule = _keys[(*result.first).second];
+	rule.type = type;
+	rule.required = required && !sec.pattern;
+}
+
+
+const bool CFGSchema::setRange(const std::string& section, const std::string& key, const double min, const double max)
+{
+	key_rule* rule = this->find_rule(section, key);
+	if (!rule)
+	{
+		std::cout << "Key \"" << key << "\" of section \"" << section << "\" isn't declared!" << "\n}" << std::endl;
+		return false;
+	}
+
+	rule->ranged = true;
+	rule->min = min;
+	rule->max = max;
+	return true;
+}
+
+
+const bool CFGSchema::setChoices(const std::string& section, const std::string& key, const std::vector<std::string>& names)
+{
+	key_rule* rule = this->find_rule(section, key);
+	if (!rule)
+	{
+		std::cout << "Key \"" << key << "\" of section \"" << section << "\" isn't declared!" << "\n}" << std::endl;
+		return false;
+	}
+
+	rule->choices.clear();
+	rule->choices.insert(names.begin(), names.end());
+	return true;
+}
+
+
+const std::size_t CFGSchema::getSectionNum() const
+{
+	return _sections.size();
+}
+
+
+const std::size_t CFGSchema::getKeyNum() const
+{
+	return _keys.size();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+const std::string CFGSchema::fold(const std::string& name) const
+{
+	if (!_case_insensitive) return name;
+
+	std::string folded(name);
+	for (char& chr : folded)
+	{
+		if (chr >= 'A' && chr <= 'Z') chr = static_cast<char>(chr - 'A' + 'a');
+	}
+
+	return folded;
+}
+
+
+const std::size_t CFGSchema::find_section(const std::string& section) const
+{
+	const std::string name = this->fold(section);
+
+	const std::unordered_map<std::string, std::size_t>::const_iterator it = _section_index.find(name);
+	if (it != _section_index.end() && !_sections[(*it).second].pattern) return (*it).second;
+
+	for (const std::size_t index : _patterns)
+	{
+		if (CFGRadixTree::match(this->fold(_sections[index].name), name)) return index;
+	}
+
+	return npos;
+}
+
+
+const std::size_t CFGSchema::find_key(const std::size_t section, const std::string& key) const
+{
+	const std::unordered_map<std::string, std::size_t>& keys = _sections[section].keys;
+	const std::unordered_map<std::string, std::size_t>::const_iterator it = keys.find(this->fold(key));
+
+	return (it != keys.end()) ? (*it).second : npos;
+}
+
+
+CFGSchema::key_rule* CFGSchema::find_rule(const std::string& section, const std::string& key)
+{
+	const std::unordered_map<std::string, std::size_t>::const_iterator it = _section_index.find(this->fold(section));
+	if (it == _section_index.end()) return nullptr;
+
+	const std::size_t index = this->find_key((*it).second, key);
+	return (index != npos) ? &_keys[index] : nullptr;
+}
@@ -0,0 +1,164 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_SCHEMA_HPP_
+#define _CFG_SCHEMA_HPP_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+
+/**
+	@brief Expected layout of a config: sections, keys, their types, ranges and required flags.
+
+	Rules are kept in hash tables by name while they are added, so checking a config is
+	a single pass over its values with one lookup per section and one per key. Required
+	names which weren't met in the pass are reported after it.
+
+	Section names may be wildcard patterns('*' and '?'), like "enemy.*". Patterns are
+	only tried for sections without an exact rule, and can't be required.
+
+	@code
+	CFGSchema schema;
+	schema.addSection("render", true);
+	schema.addKey("render", "width", CFGSchema::TYPE_INT, true);
+	schema.setRange("render", "width", 320.0, 7680.0);
+	schema.addKey("render", "backend", CFGSchema::TYPE_CHOICE);
+	schema.setChoices("render", "backend", { "vulkan", "opengl" });
+
+	CFGParser cfg;
+	cfg.setSchema(&schema);
+	cfg.load("render.ini"); // violations go to getErrors()
+	@endcode
+*/
+class CFGSchema
+{
+public:
+
+	/**
+		@brief Type of a key. Range limits the number, every vector component, the canonical unit value or the string length.
+	*/
+	enum KeyType
+	{
+		TYPE_ANY = 0x00,	// only presence is checked
+		TYPE_BOOL,
+		TYPE_INT,
+		TYPE_UINT,
+		TYPE_FLOAT,
+		TYPE_STRING,
+		TYPE_SIZE,			// getSize()
+		TYPE_DURATION,		// getDuration()
+		TYPE_PERCENT,		// getPercent()
+		TYPE_VEC2,
+		TYPE_VEC3,
+		TYPE_VEC4,
+		TYPE_CHOICE			// one of the names of setChoices()
+	};
+
+	/**
+		@brief Constructor.
+		@param Compare names ignoring ASCII case, like a parser with CFGParser::CASE_INSENSITIVE.
+	*/
+	CFGSchema(const bool case_insensitive = false);
+
+	/**
+		@brief Destructor.
+	*/
+	virtual ~CFGSchema();
+
+	/**
+		@brief Declare section. Keys of a closed section which have no rule are violations.
+	*/
+	void addSection(const std::string& section, const bool required = false, const bool closed = false);
+
+	/**
+		@brief Declare key, its section is declared if it wasn't. Redeclaring replaces type and required flag.
+	*/
+	void addKey(const std::string& section, const std::string& key, const KeyType type, const bool required = false);
+
+	/**
+		@brief Limit declared key to [min, max]. Return false, if the key isn't declared.
+	*/
+	const bool setRange(const std::string& section, const std::string& key, const double min, const double max);
+
+	/**
+		@brief Set allowed names of a TYPE_CHOICE key. Return false, if the key isn't declared.
+	*/
+	const bool setChoices(const std::string& section, const std::string& key, const std::vector<std::string>& names);
+
+	/**
+		@brief Return number of declared sections.
+	*/
+	const std::size_t getSectionNum() const;
+
+	/**
+		@brief Return number of declared keys.
+	*/
+	const std::size_t getKeyNum() const;
+
+protected:
+
+	friend class CFGParser;
+
+	static const std::size_t npos = static_cast<std::size_t>(-1);
+
+	struct key_rule
+	{
+		std::string name;
+		KeyType type;
+		bool required;
+		bool ranged;
+		double min;
+		double max;
+		std::unordered_set<std::string> choices;
+	};
+
+	struct section_rule
+	{
+		std::string name;
+		bool required;
+		bool closed;
+		bool pattern;
+		std::unordered_map<std::string, std::size_t> keys; // index in _keys
+	};
+
+	const std::string fold(const std::string& name) const;
+
+	const std::size_t find_section(const std::string& section) const;
+
+	const std::size_t find_key(const std::size_t section, const std::string& key) const;
+
+	key_rule* find_rule(const std::string& section, const std::string& key);
+
+private:
+	bool _case_insensitive;
+	std::vector<section_rule> _sections;
+	std::vector<key_rule> _keys;
+	std::unordered_map<std::string, std::size_t> _section_index; // exact names, index in _sections
+	std::vector<std::size_t> _patterns;
+
+};
+
+#endif
@@ -0,0 +1,519 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGSnapshot.hpp"
+#include <cstring>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+
+CFGSnapshot::CFGSnapshot() :
+	_control(nullptr),
+	_data(nullptr),
+	_size(0U),
+	_header(nullptr)
+{
+}
+
+
+CFGSnapshot::~CFGSnapshot()
+{
+	this->detach();
+}
+
+
+const bool CFGSnapshot::publish(const CFGParser& parser, const std::string& name)
+{
+#ifndef _WIN32
+	const int control_fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+	if (control_fd < 0 || ftruncate(control_fd, static_cast<off_t>(sizeof(control_data))) != 0)
+	{
+		if (control_fd >= 0) close(control_fd);
+		std::cout << "Snapshot \"" << name << "\" can't be created!" << "\n}" << std::endl;
+		return false;
+	}
+
+	void* control_map = mmap(nullptr, sizeof(control_data), PROT_READ | PROT_WRITE, MAP_SHARED, control_fd, 0);
+	close(control_fd);
+	if (control_map == MAP_FAILED) return false;
+
+	// A fresh segment is zero filled, which is generation 0: nothing published yet.
+	control_data* control = static_cast<control_data*>(control_map);
+	const std::uint64_t previous = control->generation.load(std::memory_order_acquire);
+	const std::uint64_t generation = previous + 1U;
+
+	std::string block;
+	bool done = build(parser, generation, block);
+
+	if (done)
+	{
+		const std::string segment = segment_name(name, generation);
+		const int fd = shm_open(segment.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+		done = (fd >= 0 && ftruncate(fd, static_cast<off_t>(block.size())) == 0);
+
+		if (done)
+		{
+			void* data = mmap(nullptr, block.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			done = (data != MAP_FAILED);
+			if (done)
+			{
+				std::memcpy(data, block.data(), block.size());
+				munmap(data, block.size());
+			}
+		}
+
+		if (fd >= 0) close(fd);
+
+		if (done)
+		{
+			control->generation.store(generation, std::memory_order_release);
+			if (previous != 0U) shm_unlink(segment_name(name, previous).c_str());
+		}
+		else
+		{
+			shm_unlink(segment.c_str());
+		}
+	}
+
+	munmap(control_map, sizeof(control_data));
+
+	if (!done) std::cout << "Snapshot \"" << name << "\" can't be written!" << "\n}" << std::endl;
+	return done;
+#else
+	std::cout << "Snapshot \"" << name << "\" can't be created, shared memory snapshots need POSIX!" << "\n}" << std::endl;
+	return false;
+#endif
+}
+
+
+void CFGSnapshot::remove(const std::string& name)
+{
+#ifndef _WIN32
+	const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) return;
+
+	void* control_map = mmap(nullptr, sizeof(control_data), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (control_map != MAP_FAILED)
+	{
+		const std::uint64_t generation = static_cast<const control_data*>(control_map)->generation.load(std::memory_order_acquire);
+		if (generation != 0U) shm_unlink(segment_name(name, generation).c_str());
+		munmap(control_map, sizeof(control_data));
+	}
+
+	shm_unlink(name.c_str());
+#endif
+}
+
+
+const bool CFGSnapshot::attach(const std::string& name)
+{
+	this->detach();
+
+#ifndef _WIN32
+	const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0)
+	{
+		std::cout << "Snapshot \"" << name << "\" doesn't exist!" << "\n}" << std::endl;
+		return false;
+	}
+
+	void* control_map = mmap(nullptr, sizeof(control_data), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (control_map == MAP_FAILED) return false;
+
+	_name = name;
+	_control = static_cast<const control_data*>(control_map);
+
+	// Publisher may switch generations between reading the control and opening the segment.
+	for (std::size_t attempt = 0U; attempt < 8U; ++attempt)
+	{
+		if (this->map(_control->generation.load(std::memory_order_acquire))) return true;
+	}
+
+	this->detach();
+	std::cout << "Snapshot \"" << name << "\" can't be mapped!" << "\n}" << std::endl;
+#endif
+	return false;
+}
+
+
+void CFGSnapshot::detach()
+{
+#ifndef _WIN32
+	if (_data) munmap(const_cast<char*>(_data), _size);
+	if (_control) munmap(const_cast<control_data*>(_control), sizeof(control_data));
+#endif
+	_name.clear();
+	_control = nullptr;
+	_data = nullptr;
+	_size = 0U;
+	_header = nullptr;
+}
+
+
+const bool CFGSnapshot::refresh()
+{
+	if (!_control) return false;
+
+	const std::uint64_t generation = _control->generation.load(std::memory_order_acquire);
+	if (_header && _header->generation == generation) return false;
+
+	return this->map(generation);
+}
+
+
+const bool CFGSnapshot::isAttached() const
+{
+	return (_header != nullptr) ? true : false;
+}
+
+
+const std::uint64_t CFGSnapshot::getGeneration() const
+{
+	return _header ? _header->generation : 0U;
+}
+
+
+const std::size_t CFGSnapshot::getKeyNum() const
+{
+	return _header ? static_cast<std::size_t>(_header->slot_num) : 0U;
+}
+
+
+const bool CFGSnapshot::getBool(const std::string& section, const std::string& key, const bool& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const char CFGSnapshot::getChar(const std::string& section, const std::string& key, const char& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned char CFGSnapshot::getUChar(const std::string& section, const std::string& key, const unsigned char& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const short CFGSnapshot::getShort(const std::string& section, const std::string& key, const short& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned short CFGSnapshot::getUShort(const std::string& section, const std::string& key, const unsigned short& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const int CFGSnapshot::getInt(const std::string& section, const std::string& key, const int& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned int CFGSnapshot::getUInt(const std::string& section, const std::string& key, const unsigned int& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const long CFGSnapshot::getLong(const std::string& section, const std::string& key, const long& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned long CFGSnapshot::getULong(const std::string& section, const std::string& key, const unsigned long& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const long long CFGSnapshot::getLLong(const std::string& section, const std::string& key, const long long& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned long long CFGSnapshot::getULLong(const std::string& section, const std::string& key, const unsigned long long& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const float CFGSnapshot::getFloat(const std::string& section, const std::string& key, const float& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const double CFGSnapshot::getDouble(const std::string& section, const std::string& key, const double& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const long double CFGSnapshot::getLDouble(const std::string& section, const std::string& key, const long double& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec2 CFGSnapshot::getVec2f(const std::string& section, const std::string& key, const Vec2& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec2i CFGSnapshot::getVec2i(const std::string& section, const std::string& key, const Vec2i& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec2u CFGSnapshot::getVec2u(const std::string& section, const std::string& key, const Vec2u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec3 CFGSnapshot::getVec3f(const std::string& section, const std::string& key, const Vec3& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec3i CFGSnapshot::getVec3i(const std::string& section, const std::string& key, const Vec3i& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec3u CFGSnapshot::getVec3u(const std::string& section, const std::string& key, const Vec3u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec4 CFGSnapshot::getVec4f(const std::string& section, const std::string& key, const Vec4& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec4i CFGSnapshot::getVec4i(const std::string& section, const std::string& key, const Vec4i& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec4u CFGSnapshot::getVec4u(const std::string& section, const std::string& key, const Vec4u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const std::string_view CFGSnapshot::getString(const std::string& section, const std::string& key, const std::string_view default_value) const
+{
+	const slot_data* slot = this->find(section, key);
+	if (slot)
+	{
+		return this->text_of(*slot);
+	}
+	else
+	{
+		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+		return default_value;
+	}
+}
+
+
+const bool CFGSnapshot::isSectionKeyExist(const std::string& section, const std::string& key) const
+{
+	return (this->find(section, key) != nullptr) ? true : false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+const bool CFGSnapshot::build(const CFGParser& parser, const std::uint64_t generation, std::string& block)
+{
+	struct entry_data
+	{
+		const std::string* section;
+		const std::string* key;
+		const std::string* value;
+	};
+
+	// Everything a getter of the parser would return: file values with overrides on top, and keys only the overrides have.
+	std::vector<entry_data> entries;
+	for (const CFGParser::section_map::value_type* sec : parser._order)
+	{
+		for (const CFGParser::value_map::value_type* val : sec->second->order)
+		{
+			const CFGParser::value_data* data = parser.find_value(sec->first, val->first);
+			entries.push_back(entry_data{ &sec->first, &val->first, &parser.value_of(*data, sec->first) });
+		}
+	}
+
+	for (const CFGParser::section_map::value_type& sec : parser._overlay)
+	{
+		const CFGParser::section_map::const_iterator it = parser._buffer.find(sec.first);
+		for (const CFGParser::value_map::value_type& val : sec.second->values)
+		{
+			if (it != parser._buffer.end() && (*it).second->values.find(val.first) != (*it).second->values.end()) continue;
+			entries.push_back(entry_data{ &sec.first, &val.first, &parser.value_of(val.second, sec.first) });
+		}
+	}
+
+	const bool fold = (parser._options & CFGParser::CASE_INSENSITIVE) != 0U;
+	const std::size_t count = entries.size();
+	std::vector<std::uint64_t> hashes(count);
+	std::vector<std::uint64_t> displacements;
+	std::vector<std::size_t> positions;
+	std::uint64_t seed = 0U;
+	bool placed = (count == 0U);
+
+	for (std::uint64_t attempt = 0U; attempt < 8U && !placed; ++attempt)
+	{
+		seed = CFGParser::hash_mix(attempt + 0x9E3779B97F4A7C15ULL);
+
+		for (std::size_t i = 0U; i < count; ++i)
+		{
+			const entry_data& entry = entries[i];
+			hashes[i] = CFGParser::hash_name(entry.key->data(), entry.key->size(), CFGParser::hash_name(entry.section->data(), entry.section->size(), seed, fold), fold);
+		}
+
+		placed = CFGParser::place_hashes(hashes, displacements, positions);
+	}
+
+	if (!placed) return false;
+
+	header_data header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = MAGIC;
+	header.generation = generation;
+	header.seed = seed;
+	header.options = parser._options;
+	header.displacement_num = displacements.size();
+	header.displacement_offset = sizeof(header_data);
+	header.slot_num = count;
+	header.slot_offset = header.displacement_offset + displacements.size() * sizeof(std::uint64_t);
+	header.text_offset = header.slot_offset + count * sizeof(slot_data);
+
+	std::vector<slot_data> slots(count);
+	std::string text;
+	for (std::size_t i = 0U; i < count; ++i)
+	{
+		slot_data& slot = slots[positions[i]];
+		slot.fingerprint = hashes[i];
+		slot.value_offset = text.size();
+		slot.value_size = entries[i].value->size();
+		text += *entries[i].value;
+	}
+
+	header.size = header.text_offset + text.size();
+
+	block.clear();
+	block.reserve(static_cast<std::size_t>(header.size));
+	block.append(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (!displacements.empty()) block.append(reinterpret_cast<const char*>(displacements.data()), displacements.size() * sizeof(std::uint64_t));
+	if (!slots.empty()) block.append(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(slot_data));
+	block += text;
+
+	return true;
+}
+
+
+const std::string CFGSnapshot::segment_name(const std::string& name, const std::uint64_t generation)
+{
+	return name + "." + std::to_string(generation);
+}
+
+
+const bool CFGSnapshot::map(const std::uint64_t generation)
+{
+#ifndef _WIN32
+	if (generation == 0U) return false;
+
+	const int fd = shm_open(segment_name(_name, generation).c_str(), O_RDONLY, 0);
+	if (fd < 0) return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(header_data))
+	{
+		close(fd);
+		return false;
+	}
+
+	const std::size_t size = static_cast<std::size_t>(info.st_size);
+	void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) return false;
+
+	const header_data* header = static_cast<const header_data*>(data);
+	if (header->magic != MAGIC || header->size != size || header->generation != generation)
+	{
+		munmap(data, size);
+		return false;
+	}
+
+	if (_data) munmap(const_cast<char*>(_data), _size);
+
+	_data = static_cast<const char*>(data);
+	_size = size;
+	_header = header;
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+const CFGSnapshot::slot_data* CFGSnapshot::find(const std::string& section, const std::string& key) const
+{
+	if (!_header || _header->slot_num == 0U) return nullptr;
+
+	const bool fold = (_header->options & CFGParser::CASE_INSENSITIVE) != 0U;
+	const std::uint64_t hash = CFGParser::hash_name(key.data(), key.size(), CFGParser::hash_name(section.data(), section.size(), _header->seed, fold), fold);
+
+	const std::uint64_t* displacements = reinterpret_cast<const std::uint64_t*>(_data + _header->displacement_offset);
+	const slot_data* slots = reinterpret_cast<const slot_data*>(_data + _header->slot_offset);
+
+	const std::uint64_t displacement = displacements[(hash >> 32U) % _header->displacement_num];
+	const slot_data& slot = slots[CFGParser::frozen_position(hash, displacement, static_cast<std::size_t>(_header->slot_num))];
+
+	return (slot.fingerprint == hash) ? &slot : nullptr;
+}
@@ -0,0 +1,315 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_SNAPSHOT_HPP_
+#define _CFG_SNAPSHOT_HPP_
+
+#include "CFGParser.hpp"
+#include <atomic>
+
+
+/**
+	@brief Parsed config, published into POSIX shared memory and read by other processes.
+
+	One process parses the files and calls publish(), any number of processes attach()
+	and read the snapshot with the usual getters. The snapshot is one position-independent
+	block: header, perfect hash slots(the same scheme as CFGParser::freeze()) and the
+	text of the values, all addressed by offsets. Values are stored with references
+	expanded and overrides applied, nothing is parsed or copied by the readers.
+
+	Every publish() writes a new segment generation and then switches a small control
+	segment to it. Readers keep their mapping until refresh(), so a publish never
+	changes data under a reader. Old segments are unlinked and disappear when the
+	last reader unmaps them. Only one process should publish under a name.
+
+	@code
+	// master
+	CFGParser cfg("server.ini");
+	CFGSnapshot::publish(cfg, "/server.cfg");
+
+	// worker
+	CFGSnapshot snapshot;
+	snapshot.attach("/server.cfg");
+	const int threads = snapshot.getInt("server", "threads", 4);
+	@endcode
+*/
+class CFGSnapshot
+{
+public:
+
+	/**
+		@brief Constructor.
+	*/
+	CFGSnapshot();
+
+	/**
+		@brief Destructor.
+	*/
+	virtual ~CFGSnapshot();
+
+	CFGSnapshot(const CFGSnapshot&) = delete;
+	CFGSnapshot& operator=(const CFGSnapshot&) = delete;
+
+	/**
+		@brief Write all values of the parser as a new generation of the named snapshot. The name must start with '/'.
+	*/
+	static const bool publish(const CFGParser& parser, const std::string& name);
+
+	/**
+		@brief Remove the named snapshot. Processes, which have it mapped, can still read it.
+	*/
+	static void remove(const std::string& name);
+
+	/**
+		@brief Map the current generation of the named snapshot read-only.
+	*/
+	const bool attach(const std::string& name);
+
+	/**
+		@brief Unmap the snapshot.
+	*/
+	void detach();
+
+	/**
+		@brief Switch to the newest generation, if it changed. Return true, if the snapshot was switched.
+	*/
+	const bool refresh();
+
+	/**
+		@brief Return true, if a snapshot is mapped.
+	*/
+	const bool isAttached() const;
+
+	/**
+		@brief Return generation of the mapped snapshot.
+	*/
+	const std::uint64_t getGeneration() const;
+
+	/**
+		@brief Return number of keys in the mapped snapshot.
+	*/
+	const std::size_t getKeyNum() const;
+
+	/**
+		@brief Return bool value. Otherwise return default value.
+	*/
+	const bool getBool(const std::string& section, const std::string& key, const bool& default_value = false) const;
+
+	/**
+		@brief Return char value. Otherwise return default value.
+	*/
+	const char getChar(const std::string& section, const std::string& key, const char& default_value = 0) const;
+
+	/**
+		@brief Return unsigned char value. Otherwise return default value.
+	*/
+	const unsigned char getUChar(const std::string& section, const std::string& key, const unsigned char& default_value = 0U) const;
+
+	/**
+		@brief Return short value. Otherwise return default value.
+	*/
+	const short getShort(const std::string& section, const std::string& key, const short& default_value = 0) const;
+
+	/**
+		@brief Return unsigned short value. Otherwise return default value.
+	*/
+	const unsigned short getUShort(const std::string& section, const std::string& key, const unsigned short& default_value = 0U) const;
+
+	/**
+		@brief Return int value. Otherwise return default value.
+	*/
+	const int getInt(const std::string& section, const std::string& key, const int& default_value = 0) const;
+
+	/**
+		@brief Return unsigned int value. Otherwise return default value.
+	*/
+	const unsigned int getUInt(const std::string& section, const std::string& key, const unsigned int& default_value = 0U) const;
+
+	/**
+		@brief Return long value. Otherwise return default value.
+	*/
+	const long getLong(const std::string& section, const std::string& key, const long& default_value = 0L) const;
+
+	/**
+		@brief Return unsigned long value. Otherwise return default value.
+	*/
+	const unsigned long getULong(const std::string& section, const std::string& key, const unsigned long& default_value = 0UL) const;
+
+	/**
+		@brief Return long long value. Otherwise return default value.
+	*/
+	const long long getLLong(const std::string& section, const std::string& key, const long long& default_value = 0LL) const;
+
+	/**
+		@brief Return unsigned long long value. Otherwise return default value.
+	*/
+	const unsigned long long getULLong(const std::string& section, const std::string& key, const unsigned long long& default_value = 0ULL) const;
+
+	/**
+		@brief Return float value. Otherwise return default value.
+	*/
+	const float getFloat(const std::string& section, const std::string& key, const float& default_value = 0.0f) const;
+
+	/**
+		@brief Return double value. Otherwise return default value.
+	*/
+	const double getDouble(const std::string& section, const std::string& key, const double& default_value = 0.0) const;
+
+	/**
+		@brief Return long double value. Otherwise return default value.
+	*/
+	const long double getLDouble(const std::string& section, const std::string& key, const long double& default_value = 0.0) const;
+
+	/**
+		@brief Return Vec2 value. Otherwise return default value.
+	*/
+	const Vec2 getVec2f(const std::string& section, const std::string& key, const Vec2& default_value = Vec2(0.0f)) const;
+
+	/**
+		@brief Return Vec2i value. Otherwise return default value.
+	*/
+	const Vec2i getVec2i(const std::string& section, const std::string& key, const Vec2i& default_value = Vec2i(0)) const;
+
+	/**
+		@brief Return Vec2u value. Otherwise return default value.
+	*/
+	const Vec2u getVec2u(const std::string& section, const std::string& key, const Vec2u& default_value = Vec2u(0U)) const;
+
+	/**
+		@brief Return Vec3 value. Otherwise return default value.
+	*/
+	const Vec3 getVec3f(const std::string& section, const std::string& key, const Vec3& default_value = Vec3(0.0f)) const;
+
+	/**
+		@brief Return Vec3i value. Otherwise return default value.
+	*/
+	const Vec3i getVec3i(const std::string& section, const std::string& key, const Vec3i& default_value = Vec3i(0)) const;
+
+	/**
+		@brief Return Vec3u value. Otherwise return default value.
+	*/
+	const Vec3u getVec3u(const std::string& section, const std::string& key, const Vec3u& default_value = Vec3u(0U)) const;
+
+	/**
+		@brief Return Vec4 value. Otherwise return default value.
+	*/
+	const Vec4 getVec4f(const std::string& section, const std::string& key, const Vec4& default_value = Vec4(0.0f)) const;
+
+	/**
+		@brief Return Vec4i value. Otherwise return default value.
+	*/
+	const Vec4i getVec4i(const std::string& section, const std::string& key, const Vec4i& default_value = Vec4i(0)) const;
+
+	/**
+		@brief Return Vec4u value. Otherwise return default value.
+	*/
+	const Vec4u getVec4u(const std::string& section, const std::string& key, const Vec4u& default_value = Vec4u(0U)) const;
+
+	/**
+		@brief Return string value, pointing into the shared memory. Otherwise return default value.
+	*/
+	const std::string_view getString(const std::string& section, const std::string& key, const std::string_view default_value = "empty_string") const;
+
+	/**
+		@brief Short check, exist key in section or not.
+	*/
+	const bool isSectionKeyExist(const std::string& section, const std::string& key) const;
+
+protected:
+
+	struct header_data
+	{
+		std::uint64_t magic;
+		std::uint64_t size;				// of the whole block
+		std::uint64_t generation;
+		std::uint64_t seed;
+		std::uint32_t options;			// of the parser
+		std::uint32_t reserved;
+		std::uint64_t displacement_num;
+		std::uint64_t displacement_offset;
+		std::uint64_t slot_num;
+		std::uint64_t slot_offset;
+		std::uint64_t text_offset;
+	};
+
+	struct slot_data
+	{
+		std::uint64_t fingerprint;
+		std::uint64_t value_offset;		// from text_offset
+		std::uint64_t value_size;
+	};
+
+	struct control_data
+	{
+		std::atomic<std::uint64_t> generation;
+	};
+
+	static const std::uint64_t MAGIC = 0x31504E5347464343ULL; // "CCFGSNP1"
+
+	static const bool build(const CFGParser& parser, const std::uint64_t generation, std::string& block);
+
+	static const std::string segment_name(const std::string& name, const std::uint64_t generation);
+
+	const bool map(const std::uint64_t generation);
+
+	const slot_data* find(const std::string& section, const std::string& key) const;
+
+	template<typename T> const T get_value(const std::string& section, const std::string& key, const T& default_value) const
+	{
+		const slot_data* slot = this->find(section, key);
+		if (slot)
+		{
+			const std::string_view str = this->text_of(*slot);
+
+			T value;
+			if (CFGParser::convert(str, value))
+			{
+				return value;
+			}
+			else
+			{
+				std::cout << "Can't convert string \"" << str << "\" of section \"" << section << "\" key \"" << key << "\" to value! Return to default value..." << "\n}" << std::endl;
+				return default_value;
+			}
+		}
+		else
+		{
+			std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+			return default_value;
+		}
+	}
+
+	inline const std::string_view text_of(const slot_data& slot) const
+	{
+		return std::string_view(_data + _header->text_offset + slot.value_offset, static_cast<std::size_t>(slot.value_size));
+	}
+
+private:
+	std::string _name;
+	const control_data* _control;
+	const char* _data;
+	std::size_t _size;
+	const header_data* _header;
+
+};
+
+#endif
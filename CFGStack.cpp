@@ -0,0 +1,295 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CFGStack.hpp"
+
+
+CFGStack::CFGStack()
+{
+}
+
+
+CFGStack::CFGStack(const CFGStack& other) :
+	_layers(other._layers)
+{
+	std::shared_lock<std::shared_mutex> lock(other._mutex);
+	_cache = other._cache;
+}
+
+
+CFGStack::~CFGStack()
+{
+	_cache.clear();
+	_layers.clear();
+}
+
+
+CFGStack& CFGStack::operator=(const CFGStack& other)
+{
+	if (this != &other)
+	{
+		_layers = other._layers;
+
+		std::shared_lock<std::shared_mutex> lock(other._mutex);
+		_cache = other._cache;
+	}
+
+	return *this;
+}
+
+
+void CFGStack::push(const layer_ptr& layer)
+{
+	if (!layer)
+	{
+		std::cout << "Can't push empty layer!" << "\n}" << std::endl;
+		return;
+	}
+
+	_layers.push_back(layer);
+	_cache.clear();
+}
+
+
+void CFGStack::pop()
+{
+	if (!_layers.empty())
+	{
+		_layers.pop_back();
+		_cache.clear();
+	}
+}
+
+
+const std::size_t CFGStack::getLayerNum() const
+{
+	return _layers.size();
+}
+
+
+const CFGStack::layer_ptr& CFGStack::getLayer(const std::size_t index) const
+{
+	return _layers.at(index);
+}
+
+
+void CFGStack::clearCache()
+{
+	_cache.clear();
+}
+
+
+const bool CFGStack::getBool(const std::string& section, const std::string& key, const bool& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const char CFGStack::getChar(const std::string& section, const std::string& key, const char& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned char CFGStack::getUChar(const std::string& section, const std::string& key, const unsigned char& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const short CFGStack::getShort(const std::string& section, const std::string& key, const short& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned short CFGStack::getUShort(const std::string& section, const std::string& key, const unsigned short& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const int CFGStack::getInt(const std::string& section, const std::string& key, const int& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned int CFGStack::getUInt(const std::string& section, const std::string& key, const unsigned int& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const long CFGStack::getLong(const std::string& section, const std::string& key, const long& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned long CFGStack::getULong(const std::string& section, const std::string& key, const unsigned long& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const long long CFGStack::getLLong(const std::string& section, const std::string& key, const long long& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const unsigned long long CFGStack::getULLong(const std::string& section, const std::string& key, const unsigned long long& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const float CFGStack::getFloat(const std::string& section, const std::string& key, const float& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const double CFGStack::getDouble(const std::string& section, const std::string& key, const double& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const long double CFGStack::getLDouble(const std::string& section, const std::string& key, const long double& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec2 CFGStack::getVec2f(const std::string& section, const std::string& key, const Vec2& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec2i CFGStack::getVec2i(const std::string& section, const std::string& key, const Vec2i& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec2u CFGStack::getVec2u(const std::string& section, const std::string& key, const Vec2u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec3 CFGStack::getVec3f(const std::string& section, const std::string& key, const Vec3& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec3i CFGStack::getVec3i(const std::string& section, const std::string& key, const Vec3i& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec3u CFGStack::getVec3u(const std::string& section, const std::string& key, const Vec3u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec4 CFGStack::getVec4f(const std::string& section, const std::string& key, const Vec4& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec4i CFGStack::getVec4i(const std::string& section, const std::string& key, const Vec4i& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const Vec4u CFGStack::getVec4u(const std::string& section, const std::string& key, const Vec4u& default_value) const
+{
+	return this->get_value(section, key, default_value);
+}
+
+
+const std::string& CFGStack::getString(const std::string& section, const std::string& key, const std::string& default_value) const
+{
+	const found_data resolved = this->resolve(section, key);
+	if (resolved.data)
+	{
+		return resolved.layer->value_of(*resolved.data, section);
+	}
+	else
+	{
+		std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+		return default_value;
+	}
+}
+
+
+const bool CFGStack::isSectionKeyExist(const std::string& section, const std::string& key) const
+{
+	return (this->resolve(section, key).data != nullptr) ? true : false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//protected functions
+/////////////////////////////////////////////////////////////////////////////////
+
+const CFGStack::found_data CFGStack::resolve(const std::string& section, const std::string& key) const
+{
+	const std::uint64_t hash = CFGParser::hash_name(key.data(), key.size(), CFGParser::hash_name(section.data(), section.size(), 0U, false), false);
+
+	{
+		std::shared_lock<std::shared_mutex> lock(_mutex);
+		std::unordered_map<std::uint64_t, resolved_data>::const_iterator it = _cache.find(hash);
+		if (it != _cache.end() && (*it).second.section == section && (*it).second.key == key) return (*it).second.found;
+	}
+
+	// Layers don't change while they are read, so the walk needs no lock.
+	resolved_data resolved;
+	resolved.section = section;
+	resolved.key = key;
+	resolved.found.layer = nullptr;
+	resolved.found.data = nullptr;
+
+	for (std::vector<layer_ptr>::const_reverse_iterator layer = _layers.rbegin(); layer != _layers.rend(); ++layer)
+	{
+		resolved.found.data = (*layer)->find_value(section, key);
+		if (resolved.found.data)
+		{
+			resolved.found.layer = (*layer).get();
+			break;
+		}
+	}
+
+	// On a hash collision the newer key takes the cache entry.
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+	_cache[hash] = resolved;
+
+	return resolved.found;
+}
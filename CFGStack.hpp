@@ -0,0 +1,279 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _CFG_STACK_HPP_
+#define _CFG_STACK_HPP_
+
+#include "CFGParser.hpp"
+#include <shared_mutex>
+
+
+/**
+	@brief Several parsed configs combined into one, e.g. defaults -> site -> host.
+
+	Layers are shared and immutable, so one defaults layer can sit under any number
+	of stacks. A lookup walks the layers from the top; its result(also a miss) is
+	remembered, so the next read of the same key is one probe of the cache.
+
+	References inside values are expanded by the layer which holds the value.
+	A layer must not change while it's in a stack, call clearCache() if it did.
+
+	The getters may be called from several threads at once, the cache is guarded by
+	a shared mutex: hits take it shared, only a miss takes it exclusively to store the
+	result. push(), pop() and clearCache() must not run concurrently with them.
+
+	@code
+	std::shared_ptr<const CFGParser> defaults = std::make_shared<const CFGParser>("defaults.ini");
+
+	CFGStack stack;
+	stack.push(defaults);
+	stack.push(std::make_shared<const CFGParser>("host.ini"));
+	const int width = stack.getInt("window", "width", 800);
+	@endcode
+*/
+class CFGStack
+{
+public:
+
+	typedef std::shared_ptr<const CFGParser> layer_ptr;
+
+	/**
+		@brief Constructor.
+	*/
+	CFGStack();
+
+	/**
+		@brief Copy constructor. Layers are shared, the cache is copied.
+	*/
+	CFGStack(const CFGStack& other);
+
+	/**
+		@brief Destructor.
+	*/
+	virtual ~CFGStack();
+
+	/**
+		@brief Copy operator. Layers are shared, the cache is copied.
+	*/
+	CFGStack& operator=(const CFGStack& other);
+
+	/**
+		@brief Put layer on top of the stack.
+	*/
+	void push(const layer_ptr& layer);
+
+	/**
+		@brief Remove the top layer.
+	*/
+	void pop();
+
+	/**
+		@brief Return number of layers.
+	*/
+	const std::size_t getLayerNum() const;
+
+	/**
+		@brief Return layer by index, 0 is the bottom one.
+	*/
+	const layer_ptr& getLayer(const std::size_t index) const;
+
+	/**
+		@brief Forget all resolved keys.
+	*/
+	void clearCache();
+
+	/**
+		@brief Return bool value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const bool getBool(const std::string& section, const std::string& key, const bool& default_value = false) const;
+
+	/**
+		@brief Return char value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const char getChar(const std::string& section, const std::string& key, const char& default_value = 0) const;
+
+	/**
+		@brief Return unsigned char value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const unsigned char getUChar(const std::string& section, const std::string& key, const unsigned char& default_value = 0U) const;
+
+	/**
+		@brief Return short value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const short getShort(const std::string& section, const std::string& key, const short& default_value = 0) const;
+
+	/**
+		@brief Return unsigned short value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const unsigned short getUShort(const std::string& section, const std::string& key, const unsigned short& default_value = 0U) const;
+
+	/**
+		@brief Return int value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const int getInt(const std::string& section, const std::string& key, const int& default_value = 0) const;
+
+	/**
+		@brief Return unsigned int value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const unsigned int getUInt(const std::string& section, const std::string& key, const unsigned int& default_value = 0U) const;
+
+	/**
+		@brief Return long value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const long getLong(const std::string& section, const std::string& key, const long& default_value = 0L) const;
+
+	/**
+		@brief Return unsigned long value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const unsigned long getULong(const std::string& section, const std::string& key, const unsigned long& default_value = 0UL) const;
+
+	/**
+		@brief Return long long value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const long long getLLong(const std::string& section, const std::string& key, const long long& default_value = 0LL) const;
+
+	/**
+		@brief Return unsigned long long value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const unsigned long long getULLong(const std::string& section, const std::string& key, const unsigned long long& default_value = 0ULL) const;
+
+	/**
+		@brief Return float value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const float getFloat(const std::string& section, const std::string& key, const float& default_value = 0.0f) const;
+
+	/**
+		@brief Return double value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const double getDouble(const std::string& section, const std::string& key, const double& default_value = 0.0) const;
+
+	/**
+		@brief Return long double value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const long double getLDouble(const std::string& section, const std::string& key, const long double& default_value = 0.0) const;
+
+	/**
+		@brief Return Vec2 value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec2 getVec2f(const std::string& section, const std::string& key, const Vec2& default_value = Vec2(0.0f)) const;
+
+	/**
+		@brief Return Vec2i value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec2i getVec2i(const std::string& section, const std::string& key, const Vec2i& default_value = Vec2i(0)) const;
+
+	/**
+		@brief Return Vec2u value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec2u getVec2u(const std::string& section, const std::string& key, const Vec2u& default_value = Vec2u(0U)) const;
+
+	/**
+		@brief Return Vec3 value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec3 getVec3f(const std::string& section, const std::string& key, const Vec3& default_value = Vec3(0.0f)) const;
+
+	/**
+		@brief Return Vec3i value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec3i getVec3i(const std::string& section, const std::string& key, const Vec3i& default_value = Vec3i(0)) const;
+
+	/**
+		@brief Return Vec3u value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec3u getVec3u(const std::string& section, const std::string& key, const Vec3u& default_value = Vec3u(0U)) const;
+
+	/**
+		@brief Return Vec4 value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec4 getVec4f(const std::string& section, const std::string& key, const Vec4& default_value = Vec4(0.0f)) const;
+
+	/**
+		@brief Return Vec4i value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec4i getVec4i(const std::string& section, const std::string& key, const Vec4i& default_value = Vec4i(0)) const;
+
+	/**
+		@brief Return Vec4u value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const Vec4u getVec4u(const std::string& section, const std::string& key, const Vec4u& default_value = Vec4u(0U)) const;
+
+	/**
+		@brief Return string value of the topmost layer having the key. Otherwise return default value.
+	*/
+	const std::string& getString(const std::string& section, const std::string& key, const std::string& default_value = "empty_string") const;
+
+	/**
+		@brief Short check, exist key in any layer or not.
+	*/
+	const bool isSectionKeyExist(const std::string& section, const std::string& key) const;
+
+protected:
+
+	struct found_data
+	{
+		const CFGParser* layer;
+		const CFGParser::value_data* data;
+	};
+
+	struct resolved_data
+	{
+		std::string section;
+		std::string key;
+		found_data found;
+	};
+
+	// Returned by value, a cache entry may be replaced by another thread after the lock is released.
+	const found_data resolve(const std::string& section, const std::string& key) const;
+
+	template<typename T> const T get_value(const std::string& section, const std::string& key, const T& default_value) const
+	{
+		const found_data resolved = this->resolve(section, key);
+		if (resolved.data)
+		{
+			const std::string& str = resolved.layer->value_of(*resolved.data, section);
+
+			T value;
+			if (CFGParser::convert(str, value))
+			{
+				return value;
+			}
+			else
+			{
+				std::cout << "Can't convert string \"" << str << "\" of section \"" << section << "\" key \"" << key << "\" to value! Return to default value..." << "\n}" << std::endl;
+				return default_value;
+			}
+		}
+		else
+		{
+			std::cout << "Section \"" << section << "\" or key \"" << key << "\" doesn't exist!" << "\n}" << std::endl;
+			return default_value;
+		}
+	}
+
+private:
+	std::vector<layer_ptr> _layers;
+	mutable std::unordered_map<std::uint64_t, resolved_data> _cache; // by hash of section and key
+	mutable std::shared_mutex _mutex; // guards _cache
+
+};
+
+#endif
@@ -0,0 +1,200 @@
+/**
+	Copyright (c) 2020 Kazim Kamilov
+
+	This software is provided 'as-is', without any express or implied
+	warranty.  In no event will the authors be held liable for any damages
+	arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute it
+	freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented; you must not
+	claim that you wrote the original software. If you use this software
+	in a product, an acknowledgment in the product documentation would be
+	appreciated but is not required.
+
+	2. Altered source versions must be plainly marked as such, and must not be
+	misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+	Regression check: a config read with freeze(), CFGPushParser or PARALLEL_PARSE
+	must give the same sections, keys, lines and values as plain load().
+
+	Build and run from the repository root:
+	g++ -std=c++17 -O2 -pthread -I. tests/CheckLoad.cpp CFG*.cpp -o check_load
+	./check_load [config ...]
+
+	Without arguments test.ini and a generated config of a few megabytes are checked,
+	the big one is split by PARALLEL_PARSE on machines with several cores. The exit
+	code is the number of failed checks.
+*/
+
+#include "CFGParser.hpp"
+#include "CFGPushParser.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+static std::size_t failures = 0U;
+
+
+static void fail(const std::string& what, const std::string& message)
+{
+	failures++;
+	if (failures <= 20U) std::cout << "FAILED " << what << ": " << message << std::endl;
+}
+
+
+static const bool read_file(const std::string& path, std::string& text)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	std::ostringstream stream;
+	stream << file.rdbuf();
+	text = stream.str();
+	return true;
+}
+
+
+static void compare(const std::string& what, const CFGParser& expected, const CFGParser& actual)
+{
+	const CFGParser::section_range left = expected.sections();
+	const CFGParser::section_range right = actual.sections();
+	if (left.size() != right.size())
+	{
+		fail(what, std::to_string(right.size()) + " sections instead of " + std::to_string(left.size()));
+		return;
+	}
+
+	CFGParser::section_iterator sec = right.begin();
+	for (const CFGParser::section_entry& section : left)
+	{
+		const CFGParser::section_entry other = *sec;
+		++sec;
+
+		const std::string name(section.name);
+		if (other.name != section.name || other.keys.size() != section.keys.size())
+		{
+			fail(what, "section \"" + std::string(other.name) + "\" instead of \"" + name + "\" or different number of keys");
+			continue;
+		}
+
+		CFGParser::key_iterator key = other.keys.begin();
+		for (const CFGParser::key_entry& entry : section.keys)
+		{
+			const CFGParser::key_entry found = *key;
+			++key;
+
+			const std::string path = name + "." + std::string(entry.key);
+			if (found.key != entry.key || found.value != entry.value || found.line != entry.line)
+			{
+				fail(what, path + " is \"" + std::string(found.key) + " = " + std::string(found.value) + "\" at line " + std::to_string(found.line));
+				continue;
+			}
+
+			// Getters go through the lookup of the parser, the frozen table for a frozen one.
+			const std::string& value = expected.getString(name, std::string(entry.key));
+			const std::string& other_value = actual.getString(name, std::string(entry.key));
+			if (value != other_value) fail(what, path + " reads \"" + other_value + "\" instead of \"" + value + "\"");
+		}
+	}
+}
+
+
+static void check(const std::string& path)
+{
+	std::string text;
+	if (!read_file(path, text))
+	{
+		fail(path, "can't be read");
+		return;
+	}
+
+	const CFGParser expected(path);
+	if (expected.getSectionNum() == 0U)
+	{
+		fail(path, "isn't loaded");
+		return;
+	}
+
+	CFGParser frozen(expected);
+	if (!frozen.freeze()) fail(path + " freeze()", "table isn't built");
+	compare(path + " freeze()", expected, frozen);
+	compare(path + " copy of frozen", expected, CFGParser(frozen));
+
+	const std::size_t chunks[] = { 1U, 7U, 4096U, text.size() };
+	for (const std::size_t chunk : chunks)
+	{
+		// Byte by byte feeding of big files takes long and checks nothing new.
+		if (chunk == 0U || (chunk == 1U && text.size() > (1U << 16U))) continue;
+
+		CFGParser pushed;
+		CFGPushParser push(pushed, path);
+		for (std::size_t i = 0U; i < text.size(); i += chunk) push.feed(text.data() + i, std::min(chunk, text.size() - i));
+		push.finish();
+
+		compare(path + " push by " + std::to_string(chunk), expected, pushed);
+	}
+
+	CFGParser parallel(CFGParser::PARALLEL_PARSE);
+	parallel.load(path);
+	compare(path + " PARALLEL_PARSE", expected, parallel);
+
+	std::cout << path << ": " << expected.getSectionNum() << " sections checked" << std::endl;
+}
+
+
+static const bool generate(const std::string& path)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	// Every 50th section is derived, references and inheritance point to earlier plain sections.
+	const auto plain = [](const std::size_t i) { return (i % 50U == 49U) ? i - 1U : i; };
+
+	// Section headers inside strings and comments, references and inheritance across parts, redefined keys.
+	for (std::size_t i = 0U; i < 20000U; ++i)
+	{
+		if (i % 50U == 49U) file << "[derived" << i << "] : s" << plain(i / 2U) << "\n";
+		else file << "[s" << i << "]\n";
+
+		file << "; [not a section] " << i << "\n";
+		file << "name = \"value [" << i << "] ; not a comment\"\n";
+		file << "size = " << (i * 4096U) << "\n";
+		file << "vec = " << i << ".5, 2, 3\n";
+		file << "ref = ${s" << plain(i / 3U) << ":size}/" << i << "\n";
+		file << "blob = hex:0a0b0c\n\n";
+		if (i % 7U == 0U) file << "size = " << i << "\n";
+	}
+
+	return static_cast<bool>(file);
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+	{
+		for (int i = 1; i < argc; ++i) check(argv[i]);
+	}
+	else
+	{
+		const std::string generated = "check_load_generated.ini";
+
+		check("test.ini");
+		if (generate(generated)) check(generated);
+		else fail(generated, "can't be written");
+
+		std::remove(generated.c_str());
+	}
+
+	std::cout << ((failures == 0U) ? "All checks passed" : std::to_string(failures) + " checks failed") << std::endl;
+	return static_cast<int>(std::min(failures, static_cast<std::size_t>(125U)));
+}
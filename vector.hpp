@@ -163,4 +163,43 @@ struct Vec4u
 	unsigned int x, y, z, w;
 };
 
+
+/**
+	@brief 16-byte aligned vectors, which are read by one aligned SIMD load. w of Vec3a is padding and stays zero.
+*/
+struct alignas(16) Vec3a
+{
+	Vec3a() : x(0.0f), y(0.0f), z(0.0f), w(0.0f)
+	{
+	}
+	
+	Vec3a(const float value) : x(value), y(value), z(value), w(0.0f)
+	{
+	}
+	
+	Vec3a(const float value_x, const float value_y, const float value_z) : x(value_x), y(value_y), z(value_z), w(0.0f)
+	{
+	}
+	
+	float x, y, z, w;
+};
+
+
+struct alignas(16) Vec4a
+{
+	Vec4a() : x(0.0f), y(0.0f), z(0.0f), w(0.0f)
+	{
+	}
+	
+	Vec4a(const float value) : x(value), y(value), z(value), w(value)
+	{
+	}
+	
+	Vec4a(const float value_x, const float value_y, const float value_z, const float value_w) : x(value_x), y(value_y), z(value_z), w(value_w)
+	{
+	}
+	
+	float x, y, z, w;
+};
+
 #endif
\ No newline at end of file